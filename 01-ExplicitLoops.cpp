@@ -3,6 +3,8 @@
 #include <vector>
 #include <string>
 
+#include "ScopeGuard/Trace.h"
+
 std::string toWords(int)
 {
     return "test"; // Just for demonstration
@@ -14,33 +16,49 @@ int main()
 
     const int count = 10;
     std::vector<int> v(count);
-    for (int i = 0; i < count; ++i)
     {
-        v[i] = std::rand() % 1000;
+        TRACE_SCOPE("generate");
+        for (int i = 0; i < count; ++i)
+        {
+            v[i] = std::rand() % 1000;
+        }
     }
     
     int countOfHundreds = 0;
-    for (size_t i = 0; i < v.size(); ++i)
     {
-        if (v[i] >= 100)
+        TRACE_SCOPE("count");
+        for (size_t i = 0; i < v.size(); ++i)
         {
-            ++countOfHundreds;
+            if (v[i] >= 100)
+            {
+                ++countOfHundreds;
+            }
         }
     }
     
     if (countOfHundreds < 5)
     {
+        TRACE_DUMP("01-ExplicitLoops.trace.json");
         return 0;
     }
     
     std::map<int, std::string> m;
-    for (size_t i = 0; i < v.size(); ++i)
     {
-        m[v[i]] = toWords(v[i]);
+        TRACE_SCOPE("transform");
+        for (size_t i = 0; i < v.size(); ++i)
+        {
+            m[v[i]] = toWords(v[i]);
+        }
     }
     
-    for (auto i = m.cbegin(); i != m.cend(); ++i)
     {
-        std::cout << i->first << " - " << i->second << '\n';
+        TRACE_SCOPE("print");
+        for (auto i = m.cbegin(); i != m.cend(); ++i)
+        {
+            std::cout << i->first << " - " << i->second << '\n';
+        }
     }
+
+    // Only when built with UTILS_ENABLE_TRACING
+    TRACE_DUMP("01-ExplicitLoops.trace.json");
 }
@@ -0,0 +1,307 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Utils
+{
+
+namespace detail
+{
+
+inline unsigned countTrailingZeros(std::uint64_t word)
+{
+#if defined(_MSC_VER) && defined(_M_IX86)
+    // No _BitScanForward64 on 32-bit x86
+    unsigned long index = 0;
+    if (_BitScanForward(&index, static_cast<unsigned long>(word)))
+    {
+        return index;
+    }
+    _BitScanForward(&index, static_cast<unsigned long>(word >> 32));
+    return index + 32;
+#elif defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanForward64(&index, word);
+    return index;
+#else
+    return static_cast<unsigned>(__builtin_ctzll(word));
+#endif
+}
+
+} // namespace detail
+
+/**
+ * \brief Map for int keys from a small, known range [Min, Max]
+ *
+ * A slot per possible key plus a bitset of which keys are present, so
+ * insertion and lookup are O(1), without allocating nodes. Iteration walks
+ * the set bits (tzcnt) and therefore visits the keys in ascending order, just
+ * like std::map.
+ *
+ * The interface is the subset of std::map that the samples use: operator[],
+ * insert() (including the hinted one, so std::inserter works), find(),
+ * count(), erase(), at(), size(), and iteration over std::pair<const int, V>.
+ *
+ * The (Max - Min + 1) slots are allocated together on the first insertion, but
+ * only the present ones are constructed. It pays off when the range isn't
+ * much bigger than the number of keys. A moved-from map is empty and usable,
+ * like a moved-from std::map.
+ */
+template <int Min, int Max, typename V>
+class DenseKeyMap
+{
+    static_assert(Min <= Max, "Empty key range");
+
+    static const std::size_t range = static_cast<std::size_t>(static_cast<long long>(Max) - Min + 1);
+    static const std::size_t words = (range + 63) / 64;
+
+public:
+    using key_type    = int;
+    using mapped_type = V;
+    using value_type  = std::pair<const int, V>;
+    using size_type   = std::size_t;
+
+    template <bool Const>
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = DenseKeyMap::value_type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = std::conditional_t<Const, const value_type*, value_type*>;
+        using reference         = std::conditional_t<Const, const value_type&, value_type&>;
+        using Owner             = std::conditional_t<Const, const DenseKeyMap, DenseKeyMap>;
+
+        Iterator() = default;
+        Iterator(Owner* map, std::size_t index) : m_map(map), m_index(index) {}
+
+        // iterator -> const_iterator
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        Iterator(const Iterator<false>& other) : m_map(other.m_map), m_index(other.m_index)
+        {
+        }
+
+        reference operator*() const { return m_map->slot(m_index); }
+        pointer operator->() const { return &m_map->slot(m_index); }
+
+        Iterator& operator++()
+        {
+            m_index = m_map->nextPresent(m_index + 1);
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) { return a.m_index == b.m_index; }
+        friend bool operator!=(const Iterator& a, const Iterator& b) { return a.m_index != b.m_index; }
+
+    private:
+        template <bool>
+        friend class Iterator;
+        friend class DenseKeyMap;
+
+        Owner* m_map        = nullptr;
+        std::size_t m_index = range; // == range for end()
+    };
+
+    using iterator       = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    DenseKeyMap() = default;
+
+    DenseKeyMap(const DenseKeyMap& other)
+    {
+        try
+        {
+            for (auto i = other.nextPresent(0); i < range; i = other.nextPresent(i + 1))
+            {
+                construct(i, other.slot(i).second);
+            }
+        }
+        catch (...)
+        {
+            // The destructor won't run, so destroy what was copied so far
+            clear();
+            throw;
+        }
+    }
+
+    DenseKeyMap(DenseKeyMap&& other) noexcept
+        : m_slots(std::move(other.m_slots)), m_present(other.m_present), m_size(other.m_size)
+    {
+        other.m_present.fill(0);
+        other.m_size = 0;
+    }
+
+    DenseKeyMap& operator=(DenseKeyMap other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    ~DenseKeyMap() { clear(); }
+
+    void swap(DenseKeyMap& other) noexcept
+    {
+        std::swap(m_slots, other.m_slots);
+        std::swap(m_present, other.m_present);
+        std::swap(m_size, other.m_size);
+    }
+
+    V& operator[](int key)
+    {
+        if (!inRange(key))
+        {
+            throw std::out_of_range("DenseKeyMap: key " + std::to_string(key) + " out of range");
+        }
+        const auto i = indexOf(key);
+        if (!isPresent(i))
+        {
+            construct(i, V());
+        }
+        return slot(i).second;
+    }
+
+    V& at(int key)
+    {
+        if (!contains(key))
+        {
+            throw std::out_of_range("DenseKeyMap: key " + std::to_string(key) + " not found");
+        }
+        return slot(indexOf(key)).second;
+    }
+
+    const V& at(int key) const { return const_cast<DenseKeyMap&>(*this).at(key); }
+
+    // Like std::map, doesn't overwrite an existing value
+    std::pair<iterator, bool> insert(const value_type& value)
+    {
+        if (!inRange(value.first))
+        {
+            throw std::out_of_range("DenseKeyMap: key " + std::to_string(value.first) + " out of range");
+        }
+        const auto i = indexOf(value.first);
+        if (isPresent(i))
+        {
+            return {iterator(this, i), false};
+        }
+        construct(i, value.second);
+        return {iterator(this, i), true};
+    }
+
+    // The hint is meaningless here; this is for std::inserter
+    iterator insert(const_iterator, const value_type& value) { return insert(value).first; }
+
+    iterator find(int key) { return contains(key) ? iterator(this, indexOf(key)) : end(); }
+    const_iterator find(int key) const { return contains(key) ? const_iterator(this, indexOf(key)) : end(); }
+
+    size_type count(int key) const { return contains(key) ? 1 : 0; }
+    bool contains(int key) const { return inRange(key) && isPresent(indexOf(key)); }
+
+    size_type erase(int key)
+    {
+        if (!contains(key))
+        {
+            return 0;
+        }
+        destroy(indexOf(key));
+        return 1;
+    }
+
+    void clear()
+    {
+        for (auto i = nextPresent(0); i < range; i = nextPresent(i + 1))
+        {
+            destroy(i);
+        }
+    }
+
+    size_type size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    iterator begin() { return iterator(this, nextPresent(0)); }
+    iterator end() { return iterator(this, range); }
+    const_iterator begin() const { return const_iterator(this, nextPresent(0)); }
+    const_iterator end() const { return const_iterator(this, range); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+private:
+    static bool inRange(int key) { return key >= Min && key <= Max; }
+    static std::size_t indexOf(int key) { return static_cast<std::size_t>(static_cast<long long>(key) - Min); }
+    static int keyOf(std::size_t index) { return static_cast<int>(Min + static_cast<long long>(index)); }
+
+    // Raw storage for one value_type, constructed only while its key is present
+    struct Slot
+    {
+        alignas(value_type) unsigned char bytes[sizeof(value_type)];
+    };
+
+    value_type& slot(std::size_t i) { return *reinterpret_cast<value_type*>(m_slots[i].bytes); }
+    const value_type& slot(std::size_t i) const { return *reinterpret_cast<const value_type*>(m_slots[i].bytes); }
+
+    bool isPresent(std::size_t i) const { return (m_present[i / 64] >> (i % 64)) & 1; }
+
+    template <typename... Args>
+    void construct(std::size_t i, Args&&... args)
+    {
+        if (!m_slots)
+        {
+            m_slots.reset(new Slot[range]);
+        }
+        new (m_slots[i].bytes) value_type(keyOf(i), std::forward<Args>(args)...);
+        m_present[i / 64] |= std::uint64_t(1) << (i % 64);
+        ++m_size;
+    }
+
+    void destroy(std::size_t i)
+    {
+        slot(i).~value_type();
+        m_present[i / 64] &= ~(std::uint64_t(1) << (i % 64));
+        --m_size;
+    }
+
+    // The first present index >= from, or range if there's none
+    std::size_t nextPresent(std::size_t from) const
+    {
+        if (from >= range)
+        {
+            return range;
+        }
+        auto w    = from / 64;
+        auto word = m_present[w] & (~std::uint64_t(0) << (from % 64));
+        while (!word)
+        {
+            if (++w == words)
+            {
+                return range;
+            }
+            word = m_present[w];
+        }
+        return w * 64 + detail::countTrailingZeros(word);
+    }
+
+    std::unique_ptr<Slot[]> m_slots;
+    std::array<std::uint64_t, words> m_present{};
+    size_type m_size = 0;
+};
+
+} // namespace Utils
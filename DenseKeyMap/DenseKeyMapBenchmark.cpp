@@ -0,0 +1,165 @@
+/*
+ * Builds the int -> words map of the 01-ExplicitLoops samples, both ways the
+ * samples do it (std::transform into std::inserter, and m[v[i]] = ...), into
+ * std::map and into DenseKeyMap, and then iterates over it in key order.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "DenseKeyMap.h"
+
+using Map      = std::map<int, std::string>;
+using DenseMap = Utils::DenseKeyMap<0, 999, std::string>;
+
+std::string toWords(int)
+{
+    return "test"; // Just for demonstration
+}
+
+int randomNum()
+{
+    return std::rand() % 1000;
+}
+
+std::pair<int, std::string> transformer(int i)
+{
+    return std::make_pair(i, toWords(i));
+}
+
+template <typename M>
+void buildWithInserter(const std::vector<int>& v, M& m)
+{
+    std::transform(v.cbegin(), v.cend(), std::inserter(m, m.begin()), transformer);
+}
+
+template <typename M>
+void buildWithSubscript(const std::vector<int>& v, M& m)
+{
+    for (size_t i = 0; i < v.size(); ++i)
+    {
+        m[v[i]] = toWords(v[i]);
+    }
+}
+
+template <typename M>
+std::string print(const M& m)
+{
+    std::ostringstream oss;
+    for (auto i = m.cbegin(); i != m.cend(); ++i)
+    {
+        oss << i->first << " - " << i->second << '\n';
+    }
+    return oss.str();
+}
+
+template <typename M>
+std::size_t iterate(const M& m)
+{
+    std::size_t sum = 0;
+    for (const auto& p : m)
+    {
+        sum += p.first + p.second.size();
+    }
+    return sum;
+}
+
+template <typename Func>
+double measureSeconds(Func func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+bool checkSameAsMap(const std::vector<int>& v)
+{
+    Map m1, m2;
+    DenseMap d1, d2;
+    buildWithInserter(v, m1);
+    buildWithInserter(v, d1);
+    buildWithSubscript(v, m2);
+    buildWithSubscript(v, d2);
+    return print(m1) == print(d1) && print(m2) == print(d2) && m1.size() == d1.size() && m2.size() == d2.size();
+}
+
+// The maps are built and iterated a few at a time, reusing them (clear())
+// between batches like a long-running program would. Keeping them all alive,
+// or allocating new ones each time, mostly measures page faults for the
+// slots of DenseKeyMap (the allocator returns them to the OS when freed).
+template <typename M, typename Build>
+void benchmark(const char* name, const std::vector<std::vector<int>>& inputs, Build build, int passes)
+{
+    std::vector<M> maps(16);
+
+    double buildTime   = 0;
+    double iterateTime = 0;
+    std::size_t sum    = 0;
+    for (int pass = 0; pass < passes; ++pass)
+    {
+        for (std::size_t first = 0; first < inputs.size(); first += maps.size())
+        {
+            const auto count = std::min(maps.size(), inputs.size() - first);
+            buildTime += measureSeconds([&] {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    maps[i].clear();
+                    build(inputs[first + i], maps[i]);
+                }
+            });
+            iterateTime += measureSeconds([&] {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    sum += iterate(maps[i]);
+                }
+            });
+        }
+    }
+
+    const double perMap = 1e9 / (static_cast<double>(inputs.size()) * passes);
+    std::cout << "  " << name << ": build " << buildTime * perMap << " ns, iterate " << iterateTime * perMap
+              << " ns per map (" << sum << ")\n";
+}
+
+int main() try
+{
+    std::srand(4);
+
+    std::vector<int> sample(10);
+    std::generate_n(sample.begin(), sample.size(), randomNum);
+    const bool same = checkSameAsMap(sample);
+    std::cout << "Same output as std::map: " << (same ? "yes" : "NO") << '\n';
+    if (!same)
+    {
+        return EXIT_FAILURE;
+    }
+
+    const int passes = 5;
+    for (const std::size_t count : {10, 100, 1000})
+    {
+        std::vector<std::vector<int>> inputs(100000 / count, std::vector<int>(count));
+        for (auto& v : inputs)
+        {
+            std::generate_n(v.begin(), v.size(), randomNum);
+        }
+
+        std::cout << inputs.size() << " maps of " << count << " keys:\n";
+        benchmark<Map>("std::map,    inserter ", inputs, buildWithInserter<Map>, passes);
+        benchmark<DenseMap>("DenseKeyMap, inserter ", inputs, buildWithInserter<DenseMap>, passes);
+        benchmark<Map>("std::map,    m[i] = ...", inputs, buildWithSubscript<Map>, passes);
+        benchmark<DenseMap>("DenseKeyMap, m[i] = ...", inputs, buildWithSubscript<DenseMap>, passes);
+    }
+}
+catch (std::exception& e)
+{
+    std::cerr << "Exception: " << e.what() << '\n';
+    return EXIT_FAILURE;
+}
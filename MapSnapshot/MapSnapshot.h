@@ -0,0 +1,304 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../RAII/MappedFile.h"
+
+namespace Utils
+{
+
+/*
+ * Snapshot file format (version 1), all integers in the byte order of the
+ * machine that wrote it:
+ *
+ *   header    magic "IWMS", version, byte order mark, count, pool size (u32 each)
+ *   keys      count x i32, ascending
+ *   offsets   (count + 1) x u32, where value i is pool[offsets[i], offsets[i + 1])
+ *   pool      the values, back to back, no terminators
+ *
+ * Everything is addressed relative to the start of the file, so it can be
+ * mapped anywhere, and every array is 4-byte aligned.
+ */
+namespace detail
+{
+
+struct SnapshotHeader
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint32_t count;
+    std::uint32_t poolSize;
+};
+
+const char snapshotMagic[4]           = {'I', 'W', 'M', 'S'};
+const std::uint32_t snapshotVersion   = 1;
+const std::uint32_t snapshotByteOrder = 0x01020304;
+
+// Replaces to with from in one step, so that readers see either file whole.
+// On Windows this fails while to is open (e.g. mapped by a MapSnapshot).
+inline bool replaceFile(const std::string& from, const std::string& to)
+{
+#ifdef _WIN32
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+} // namespace detail
+
+/**
+ * \brief Writes an int -> string map to path as a snapshot MapSnapshot can load
+ *
+ * Map is anything that iterates over pairs of int and std::string (std::map,
+ * DenseKeyMap, ...); if it isn't ordered by key, the entries are sorted.
+ * The snapshot is written to path + ".tmp" and then renamed over path, so it
+ * is never seen half-written. On POSIX, a process that has the previous
+ * snapshot mapped keeps reading it intact. On Windows, the file can't be
+ * replaced while any process has it mapped: writing fails (and path is left
+ * as it was) until the readers are gone.
+ *
+ * Throws std::runtime_error if the file can't be written or replaced, or if
+ * the map doesn't fit the format (more than 4GB of values).
+ */
+template <typename Map>
+void writeMapSnapshot(const Map& map, const std::string& path)
+{
+    std::vector<std::pair<int, const std::string*>> entries;
+    for (const auto& p : map)
+    {
+        entries.emplace_back(p.first, &p.second);
+    }
+    const auto byKey = [](const auto& a, const auto& b) { return a.first < b.first; };
+    if (!std::is_sorted(entries.begin(), entries.end(), byKey))
+    {
+        std::sort(entries.begin(), entries.end(), byKey);
+    }
+
+    std::vector<std::int32_t> keys;
+    std::vector<std::uint32_t> offsets;
+    keys.reserve(entries.size());
+    offsets.reserve(entries.size() + 1);
+    std::uint64_t poolSize = 0;
+    for (const auto& e : entries)
+    {
+        keys.push_back(e.first);
+        offsets.push_back(static_cast<std::uint32_t>(poolSize));
+        poolSize += e.second->size();
+        if (poolSize > UINT32_MAX)
+        {
+            throw std::runtime_error("writeMapSnapshot: values too big for the snapshot format");
+        }
+    }
+    offsets.push_back(static_cast<std::uint32_t>(poolSize));
+
+    detail::SnapshotHeader header;
+    std::memcpy(header.magic, detail::snapshotMagic, sizeof(header.magic));
+    header.version   = detail::snapshotVersion;
+    header.byteOrder = detail::snapshotByteOrder;
+    header.count     = static_cast<std::uint32_t>(entries.size());
+    header.poolSize  = static_cast<std::uint32_t>(poolSize);
+
+    const auto tmpPath = path + ".tmp";
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(keys.data()), keys.size() * sizeof(keys[0]));
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(offsets[0]));
+    for (const auto& e : entries)
+    {
+        out.write(e.second->data(), e.second->size());
+    }
+    out.close();
+    if (!out)
+    {
+        std::remove(tmpPath.c_str());
+        throw std::runtime_error("writeMapSnapshot: failed to write " + tmpPath);
+    }
+    if (!detail::replaceFile(tmpPath, path))
+    {
+        std::remove(tmpPath.c_str());
+        throw std::runtime_error("writeMapSnapshot: failed to replace " + path);
+    }
+}
+
+/**
+ * \brief Read-only int -> string map served straight from a mapped snapshot
+ *
+ * Loading maps the file and checks its header and size, nothing more: there
+ * is no parsing and no allocation, so it costs about the same for any number
+ * of entries, and pages are read only when a lookup touches them.
+ *
+ * find() is a binary search over the keys; iteration is in ascending key
+ * order, over std::pair<int, std::string_view>. The string_views point into
+ * the mapping, so they are valid as long as the snapshot is.
+ *
+ * Throws std::runtime_error if the file isn't a valid snapshot of this
+ * version (or was written on a machine with a different byte order).
+ *
+ * This class is NonCopyable and NonMovable, like the MappedFile it holds.
+ */
+class MapSnapshot
+{
+public:
+    using value_type = std::pair<int, std::string_view>;
+
+    // Input iterator: it holds the pair it returns a reference to
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = MapSnapshot::value_type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const value_type*;
+        using reference         = const value_type&;
+
+        const_iterator(const MapSnapshot* snapshot, std::uint32_t index) : m_snapshot(snapshot), m_index(index)
+        {
+            load();
+        }
+
+        reference operator*() const { return m_current; }
+        pointer operator->() const { return &m_current; }
+
+        const_iterator& operator++()
+        {
+            ++m_index;
+            load();
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        friend bool operator==(const const_iterator& a, const const_iterator& b) { return a.m_index == b.m_index; }
+        friend bool operator!=(const const_iterator& a, const const_iterator& b) { return a.m_index != b.m_index; }
+
+    private:
+        void load()
+        {
+            if (m_index < m_snapshot->m_count)
+            {
+                m_current = {m_snapshot->m_keys[m_index], m_snapshot->valueAt(m_index)};
+            }
+        }
+
+        const MapSnapshot* m_snapshot;
+        std::uint32_t m_index;
+        value_type m_current;
+    };
+
+    explicit MapSnapshot(const std::string& path);
+
+    MapSnapshot(const MapSnapshot&) = delete;
+    MapSnapshot& operator=(const MapSnapshot&) = delete;
+
+    std::size_t size() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+
+    std::optional<std::string_view> find(int key) const;
+    bool contains(int key) const { return find(key).has_value(); }
+    std::string_view at(int key) const;
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_count); }
+
+private:
+    std::string_view valueAt(std::uint32_t index) const;
+
+    MappedFile m_file;
+    std::uint32_t m_count          = 0;
+    const std::int32_t* m_keys     = nullptr;
+    const std::uint32_t* m_offsets = nullptr;
+    const char* m_pool             = nullptr;
+    std::uint32_t m_poolSize       = 0;
+};
+
+inline MapSnapshot::MapSnapshot(const std::string& path) : m_file(path, MappedFile::Access::Random)
+{
+    detail::SnapshotHeader header;
+    if (m_file.size() < sizeof(header))
+    {
+        throw std::runtime_error(path + " is not a map snapshot (too small)");
+    }
+    std::memcpy(&header, m_file.data(), sizeof(header));
+    if (std::memcmp(header.magic, detail::snapshotMagic, sizeof(header.magic)) != 0)
+    {
+        throw std::runtime_error(path + " is not a map snapshot");
+    }
+    if (header.byteOrder != detail::snapshotByteOrder)
+    {
+        throw std::runtime_error(path + " was written with a different byte order");
+    }
+    if (header.version != detail::snapshotVersion)
+    {
+        throw std::runtime_error(path + " is a version " + std::to_string(header.version) +
+                                 " map snapshot, expected version " + std::to_string(detail::snapshotVersion));
+    }
+
+    const auto expectedSize = sizeof(header) + std::uint64_t(header.count) * sizeof(std::int32_t) +
+                              (std::uint64_t(header.count) + 1) * sizeof(std::uint32_t) + header.poolSize;
+    if (m_file.size() != expectedSize)
+    {
+        throw std::runtime_error(path + " is truncated or corrupted (size " + std::to_string(m_file.size()) +
+                                 ", expected " + std::to_string(expectedSize) + ')');
+    }
+
+    // The mapping is page aligned and the arrays are 4-byte aligned within it
+    m_count    = header.count;
+    m_keys     = reinterpret_cast<const std::int32_t*>(m_file.data() + sizeof(header));
+    m_offsets  = reinterpret_cast<const std::uint32_t*>(m_keys + m_count);
+    m_pool     = reinterpret_cast<const char*>(m_offsets + m_count + 1);
+    m_poolSize = header.poolSize;
+}
+
+inline std::optional<std::string_view> MapSnapshot::find(int key) const
+{
+    const auto last = m_keys + m_count;
+    const auto it   = std::lower_bound(m_keys, last, key);
+    if (it == last || *it != key)
+    {
+        return std::nullopt;
+    }
+    return valueAt(static_cast<std::uint32_t>(it - m_keys));
+}
+
+inline std::string_view MapSnapshot::at(int key) const
+{
+    const auto value = find(key);
+    if (!value)
+    {
+        throw std::out_of_range("MapSnapshot: key " + std::to_string(key) + " not found");
+    }
+    return *value;
+}
+
+// The offsets are checked here rather than when loading, so that loading
+// doesn't have to read the whole offsets array
+inline std::string_view MapSnapshot::valueAt(std::uint32_t index) const
+{
+    const auto first = m_offsets[index];
+    const auto last  = m_offsets[index + 1];
+    if (first > last || last > m_poolSize)
+    {
+        throw std::runtime_error("MapSnapshot: corrupted offsets for entry " + std::to_string(index));
+    }
+    return std::string_view(m_pool + first, last - first);
+}
+
+} // namespace Utils
@@ -0,0 +1,187 @@
+/*
+ * The 01-ExplicitLoops programs compute their int -> words map from scratch
+ * on every run. This writes the computed map once as a snapshot, and then
+ * compares what a run costs each way: rebuilding the std::map vs loading the
+ * snapshot, and then lookups and ordered iteration on each.
+ *
+ * Usage: MapSnapshotBenchmark [snapshot file]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "MapSnapshot.h"
+
+// A real one this time, so that rebuilding the map costs what it would
+std::string toWords(int n)
+{
+    static const char* const ones[] = {"zero",    "one",     "two",       "three",    "four",
+                                       "five",    "six",     "seven",     "eight",    "nine",
+                                       "ten",     "eleven",  "twelve",    "thirteen", "fourteen",
+                                       "fifteen", "sixteen", "seventeen", "eighteen", "nineteen"};
+    static const char* const tens[] = {"", "", "twenty", "thirty", "forty", "fifty", "sixty", "seventy", "eighty",
+                                       "ninety"};
+
+    if (n < 0)
+    {
+        return "minus " + toWords(-n);
+    }
+    if (n < 20)
+    {
+        return ones[n];
+    }
+    if (n < 100)
+    {
+        return std::string(tens[n / 10]) + (n % 10 ? std::string("-") + ones[n % 10] : "");
+    }
+
+    static const std::pair<int, const char*> scales[] = {
+        {1000000000, "billion"}, {1000000, "million"}, {1000, "thousand"}, {100, "hundred"}};
+    for (const auto& scale : scales)
+    {
+        if (n >= scale.first)
+        {
+            const auto rest = n % scale.first;
+            return toWords(n / scale.first) + ' ' + scale.second + (rest ? ' ' + toWords(rest) : "");
+        }
+    }
+    return std::string(); // Unreachable
+}
+
+std::vector<int> makeKeys(std::size_t count)
+{
+    std::mt19937 gen(4);
+    std::uniform_int_distribution<int> dist(0, static_cast<int>(count) * 10);
+    std::vector<int> keys(count);
+    for (auto& key : keys)
+    {
+        key = dist(gen);
+    }
+    return keys;
+}
+
+std::map<int, std::string> buildMap(const std::vector<int>& keys)
+{
+    std::map<int, std::string> m;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        m[keys[i]] = toWords(keys[i]);
+    }
+    return m;
+}
+
+template <typename Func>
+double measureSeconds(Func func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+template <typename Map>
+std::size_t iterate(const Map& m)
+{
+    std::size_t sum = 0;
+    for (const auto& p : m)
+    {
+        sum += p.first + p.second.size();
+    }
+    return sum;
+}
+
+bool sameContents(const std::map<int, std::string>& m, const Utils::MapSnapshot& snapshot)
+{
+    if (m.size() != snapshot.size())
+    {
+        return false;
+    }
+    auto s = snapshot.begin();
+    for (auto i = m.cbegin(); i != m.cend(); ++i, ++s)
+    {
+        if (i->first != s->first || i->second != s->second || snapshot.at(i->first) != i->second)
+        {
+            return false;
+        }
+    }
+    return !snapshot.contains(-1);
+}
+
+int main(int argc, char* argv[]) try
+{
+    const std::string path = argc > 1 ? argv[1] : "words.snapshot";
+
+    bool allSame = true;
+
+    for (const std::size_t count : {1000, 100000, 1000000})
+    {
+        const auto keys = makeKeys(count);
+
+        std::map<int, std::string> m;
+        const auto buildTime = measureSeconds([&] { m = buildMap(keys); });
+        const auto writeTime = measureSeconds([&] { Utils::writeMapSnapshot(m, path); });
+
+        std::size_t loadedSize = 0;
+        const auto loadTime    = measureSeconds([&] {
+            Utils::MapSnapshot snapshot(path);
+            loadedSize = snapshot.size();
+        });
+
+        const Utils::MapSnapshot snapshot(path);
+        const bool same = loadedSize == m.size() && sameContents(m, snapshot);
+
+        std::mt19937 gen(2016);
+        std::uniform_int_distribution<std::size_t> pick(0, keys.size() - 1);
+        std::vector<int> lookups(1000000);
+        for (auto& key : lookups)
+        {
+            key = keys[pick(gen)];
+        }
+
+        std::size_t mapFound = 0;
+        const auto mapLookupTime = measureSeconds([&] {
+            for (const auto key : lookups)
+            {
+                const auto it = m.find(key);
+                mapFound += it != m.end() ? it->second.size() : 0;
+            }
+        });
+        std::size_t snapshotFound = 0;
+        const auto snapshotLookupTime = measureSeconds([&] {
+            for (const auto key : lookups)
+            {
+                const auto value = snapshot.find(key);
+                snapshotFound += value ? value->size() : 0;
+            }
+        });
+
+        std::size_t mapSum = 0, snapshotSum = 0;
+        const auto mapIterateTime      = measureSeconds([&] { mapSum = iterate(m); });
+        const auto snapshotIterateTime = measureSeconds([&] { snapshotSum = iterate(snapshot); });
+
+        const double lookupScale = 1e9 / lookups.size();
+        std::cout << m.size() << " entries (" << loadedSize << " loaded, same contents: " << (same ? "yes" : "NO")
+                  << "), snapshot written in " << writeTime * 1e3 << " ms:\n"
+                  << "  startup:  rebuild " << buildTime * 1e3 << " ms, load snapshot " << loadTime * 1e3 << " ms\n"
+                  << "  lookup:   std::map " << mapLookupTime * lookupScale << " ns, snapshot "
+                  << snapshotLookupTime * lookupScale << " ns (" << mapFound << ' ' << snapshotFound << ")\n"
+                  << "  iterate:  std::map " << mapIterateTime * 1e3 << " ms, snapshot " << snapshotIterateTime * 1e3
+                  << " ms (" << mapSum << ' ' << snapshotSum << ")\n";
+
+        allSame = allSame && same && mapFound == snapshotFound && mapSum == snapshotSum;
+    }
+
+    std::remove(path.c_str());
+    return allSame ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+catch (std::exception& e)
+{
+    std::cerr << "Exception: " << e.what() << '\n';
+    return EXIT_FAILURE;
+}
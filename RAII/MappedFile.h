@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Utils
+{
+
+/**
+ * \brief Read-only memory mapping of a whole file
+ *
+ * RAII wrapper around mmap() / MapViewOfFile(); throws std::runtime_error if
+ * the file can't be opened or mapped. An empty file gives an empty mapping
+ * (data() == nullptr), as neither API can map zero bytes.
+ *
+ * The access hint tells the OS whether to read ahead (Sequential, for
+ * streaming through the file) or not (Random, for lookups). It is only
+ * effective on POSIX (madvise()); on Windows it's passed to CreateFile(),
+ * which applies it to cached ReadFile() calls, not to the mapped view.
+ *
+ * On Windows the file handle stays open while mapped, so the file can't be
+ * deleted or replaced until the MappedFile is destroyed.
+ *
+ * This class is NonCopyable and NonMovable, which is enough for keeping it
+ * on the stack while processing the file.
+ */
+class MappedFile
+{
+public:
+    enum class Access
+    {
+        Sequential,
+        Random
+    };
+
+    explicit MappedFile(const std::string& path, Access access = Access::Sequential);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+
+private:
+    const char* m_data = nullptr;
+    std::size_t m_size = 0;
+#ifdef _WIN32
+    HANDLE m_file    = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+#endif
+};
+
+#ifdef _WIN32
+
+inline MappedFile::MappedFile(const std::string& path, Access access)
+{
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                         access == Access::Sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS,
+                         nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error("Failed to open " + path);
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size))
+    {
+        CloseHandle(m_file);
+        throw std::runtime_error("Failed to get the size of " + path);
+    }
+    m_size = static_cast<std::size_t>(size.QuadPart);
+    if (m_size == 0)
+    {
+        return;
+    }
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping)
+    {
+        m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (!m_data)
+    {
+        if (m_mapping)
+        {
+            CloseHandle(m_mapping);
+        }
+        CloseHandle(m_file);
+        throw std::runtime_error("Failed to map " + path);
+    }
+}
+
+inline MappedFile::~MappedFile()
+{
+    if (m_data)
+    {
+        UnmapViewOfFile(m_data);
+        CloseHandle(m_mapping);
+    }
+    CloseHandle(m_file);
+}
+
+#else
+
+inline MappedFile::MappedFile(const std::string& path, Access access)
+{
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Failed to open " + path);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        throw std::runtime_error("Failed to get the size of " + path);
+    }
+    m_size = static_cast<std::size_t>(st.st_size);
+    if (m_size == 0)
+    {
+        close(fd);
+        return;
+    }
+
+    void* p = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping keeps its own reference to the file
+    if (p == MAP_FAILED)
+    {
+        throw std::runtime_error("Failed to map " + path);
+    }
+    madvise(p, m_size, access == Access::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+    m_data = static_cast<const char*>(p);
+}
+
+inline MappedFile::~MappedFile()
+{
+    if (m_data)
+    {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+}
+
+#endif
+
+} // namespace Utils
@@ -18,6 +18,7 @@
 #pragma comment(lib, "wbemuuid.lib")
 
 #include "COMStyleUniquePtr.h"
+#include "../ScopeGuard/Trace.h"
 
 std::string toHex(int value)
 {
@@ -30,6 +31,7 @@ struct CoInitHandler
 {
     CoInitHandler(COINIT mode)
     {
+        TRACE_SCOPE("Step 1: CoInitializeEx");
         auto hres = CoInitializeEx(0, mode);
         if (FAILED(hres))
         {
@@ -45,6 +47,7 @@ struct CoInitHandler
 
 auto createLocator()
 {
+    TRACE_SCOPE("Step 3: createLocator");
     IWbemLocator *pLoc = NULL;
 
     auto hres = CoCreateInstance(CLSID_WbemLocator, 0, CLSCTX_INPROC_SERVER, IID_IWbemLocator, (LPVOID*)&pLoc);
@@ -59,6 +62,7 @@ auto createLocator()
 
 auto connectServer(IWbemLocator& loc)
 {
+    TRACE_SCOPE("Step 4: connectServer");
     IWbemServices *pSvc = NULL;
 
     // Connect to the root\cimv2 namespace with
@@ -82,6 +86,7 @@ auto connectServer(IWbemLocator& loc)
 
 auto execQuery(IWbemServices& svc)
 {
+    TRACE_SCOPE("Step 6: execQuery");
     IEnumWbemClassObject* pEnumerator = NULL;
     auto hres = svc.ExecQuery(bstr_t("WQL"),
                               bstr_t("SELECT * FROM Win32_OperatingSystem"),
@@ -99,6 +104,7 @@ auto execQuery(IWbemServices& svc)
 
 auto getNext(IEnumWbemClassObject& enumerator)
 {
+    TRACE_SCOPE("Step 7: getNext");
     IWbemClassObject *pclsObj = nullptr;
     ULONG uReturn = 0;
     HRESULT hr = enumerator.Next(WBEM_INFINITE,
@@ -119,16 +125,20 @@ int main() try
     // Step 2: --------------------------------------------------
     // Set general COM security levels --------------------------
 
-    auto hres = CoInitializeSecurity(NULL,
-                                     -1,                          // COM authentication
-                                     NULL,                        // Authentication services
-                                     NULL,                        // Reserved
-                                     RPC_C_AUTHN_LEVEL_DEFAULT,   // Default authentication
-                                     RPC_C_IMP_LEVEL_IMPERSONATE, // Default Impersonation
-                                     NULL,                        // Authentication info
-                                     EOAC_NONE,                   // Additional capabilities
-                                     NULL                         // Reserved
-                                     );
+    HRESULT hres = S_OK;
+    {
+        TRACE_SCOPE("Step 2: CoInitializeSecurity");
+        hres = CoInitializeSecurity(NULL,
+                                    -1,                          // COM authentication
+                                    NULL,                        // Authentication services
+                                    NULL,                        // Reserved
+                                    RPC_C_AUTHN_LEVEL_DEFAULT,   // Default authentication
+                                    RPC_C_IMP_LEVEL_IMPERSONATE, // Default Impersonation
+                                    NULL,                        // Authentication info
+                                    EOAC_NONE,                   // Additional capabilities
+                                    NULL                         // Reserved
+                                    );
+    }
 
     if (FAILED(hres))
     {
@@ -149,14 +159,17 @@ int main() try
     // Step 5: --------------------------------------------------
     // Set security levels on the proxy -------------------------
 
-    hres = CoSetProxyBlanket(pSvc.get(),                  // Indicates the proxy to set
-                             RPC_C_AUTHN_WINNT,           // RPC_C_AUTHN_xxx
-                             RPC_C_AUTHZ_NONE,            // RPC_C_AUTHZ_xxx
-                             NULL,                        // Server principal name 
-                             RPC_C_AUTHN_LEVEL_CALL,      // RPC_C_AUTHN_LEVEL_xxx 
-                             RPC_C_IMP_LEVEL_IMPERSONATE, // RPC_C_IMP_LEVEL_xxx
-                             NULL,                        // client identity
-                             EOAC_NONE);                  // proxy capabilities 
+    {
+        TRACE_SCOPE("Step 5: CoSetProxyBlanket");
+        hres = CoSetProxyBlanket(pSvc.get(),                  // Indicates the proxy to set
+                                 RPC_C_AUTHN_WINNT,           // RPC_C_AUTHN_xxx
+                                 RPC_C_AUTHZ_NONE,            // RPC_C_AUTHZ_xxx
+                                 NULL,                        // Server principal name 
+                                 RPC_C_AUTHN_LEVEL_CALL,      // RPC_C_AUTHN_LEVEL_xxx 
+                                 RPC_C_IMP_LEVEL_IMPERSONATE, // RPC_C_IMP_LEVEL_xxx
+                                 NULL,                        // client identity
+                                 EOAC_NONE);                  // proxy capabilities 
+    }
 
     if (FAILED(hres))
     {
@@ -187,6 +200,9 @@ int main() try
         hres = pclsObj->Get(L"Name", 0, &vtProp, 0, 0);
         std::wcout << " OS Name: " << vtProp.bstrVal << L'\n';
     }
+
+    // Only when built with UTILS_ENABLE_TRACING
+    TRACE_DUMP("RAIISample.trace.json");
 }
 catch(std::exception& e)
 {
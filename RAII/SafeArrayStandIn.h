@@ -0,0 +1,201 @@
+#pragma once
+
+/**
+ * \brief Minimal stand-in for SAFEARRAY and VARIANT, for non-Windows builds
+ *
+ * Just enough of the OLE Automation API (same names, same behavior for what
+ * we use) to build and exercise SafeArrayView on other platforms. Unlike the
+ * real SAFEARRAY, the element VARTYPE is a plain member of the descriptor.
+ *
+ * On Windows this file is empty; the real API is used.
+ */
+
+#ifndef _WIN32
+
+#include <cstdint>
+#include <cstdlib>
+
+typedef std::int32_t HRESULT;
+typedef std::int32_t LONG;
+typedef std::uint32_t ULONG;
+typedef unsigned int UINT;
+typedef std::uint16_t USHORT;
+typedef std::uint16_t VARTYPE;
+
+const HRESULT S_OK                 = 0;
+const HRESULT E_INVALIDARG         = static_cast<HRESULT>(0x80070057);
+const HRESULT E_UNEXPECTED         = static_cast<HRESULT>(0x8000FFFF);
+const HRESULT DISP_E_ARRAYISLOCKED = static_cast<HRESULT>(0x8002000D);
+
+#define SUCCEEDED(hr) (static_cast<HRESULT>(hr) >= 0)
+#define FAILED(hr) (static_cast<HRESULT>(hr) < 0)
+
+enum : VARTYPE
+{
+    VT_EMPTY = 0,
+    VT_I2    = 2,
+    VT_I4    = 3,
+    VT_R4    = 4,
+    VT_R8    = 5,
+    VT_I1    = 16,
+    VT_UI1   = 17,
+    VT_UI2   = 18,
+    VT_UI4   = 19,
+    VT_ARRAY = 0x2000,
+};
+
+struct SAFEARRAYBOUND
+{
+    ULONG cElements;
+    LONG lLbound;
+};
+
+struct SAFEARRAY
+{
+    USHORT cDims;
+    USHORT fFeatures;
+    ULONG cbElements;
+    ULONG cLocks;
+    void* pvData;
+    VARTYPE vt; // Stand-in only
+    SAFEARRAYBOUND rgsabound[1]; // Actually cDims of them
+};
+
+struct VARIANT
+{
+    VARTYPE vt;
+    SAFEARRAY* parray;
+};
+
+inline ULONG standInElementSize(VARTYPE vt)
+{
+    switch (vt)
+    {
+    case VT_I1:
+    case VT_UI1:
+        return 1;
+    case VT_I2:
+    case VT_UI2:
+        return 2;
+    case VT_I4:
+    case VT_UI4:
+    case VT_R4:
+        return 4;
+    case VT_R8:
+        return 8;
+    }
+    return 0;
+}
+
+inline SAFEARRAY* SafeArrayCreate(VARTYPE vt, UINT cDims, SAFEARRAYBOUND* rgsabound)
+{
+    const auto elementSize = standInElementSize(vt);
+    if (elementSize == 0 || cDims == 0 || !rgsabound)
+    {
+        return nullptr;
+    }
+
+    ULONG elements = 1;
+    for (UINT i = 0; i < cDims; ++i)
+    {
+        elements *= rgsabound[i].cElements;
+    }
+
+    auto* psa = static_cast<SAFEARRAY*>(std::calloc(1, sizeof(SAFEARRAY) + (cDims - 1) * sizeof(SAFEARRAYBOUND)));
+    psa->cDims      = static_cast<USHORT>(cDims);
+    psa->cbElements = elementSize;
+    psa->pvData     = std::calloc(elements ? elements : 1, elementSize);
+    psa->vt         = vt;
+    for (UINT i = 0; i < cDims; ++i)
+    {
+        psa->rgsabound[i] = rgsabound[i];
+    }
+    return psa;
+}
+
+inline SAFEARRAY* SafeArrayCreateVector(VARTYPE vt, LONG lLbound, ULONG cElements)
+{
+    SAFEARRAYBOUND bound = {cElements, lLbound};
+    return SafeArrayCreate(vt, 1, &bound);
+}
+
+inline HRESULT SafeArrayDestroy(SAFEARRAY* psa)
+{
+    if (!psa)
+    {
+        return S_OK;
+    }
+    if (psa->cLocks > 0)
+    {
+        return DISP_E_ARRAYISLOCKED;
+    }
+    std::free(psa->pvData);
+    std::free(psa);
+    return S_OK;
+}
+
+inline HRESULT SafeArrayLock(SAFEARRAY* psa)
+{
+    if (!psa)
+    {
+        return E_INVALIDARG;
+    }
+    ++psa->cLocks;
+    return S_OK;
+}
+
+inline HRESULT SafeArrayUnlock(SAFEARRAY* psa)
+{
+    if (!psa)
+    {
+        return E_INVALIDARG;
+    }
+    if (psa->cLocks == 0)
+    {
+        return E_UNEXPECTED;
+    }
+    --psa->cLocks;
+    return S_OK;
+}
+
+inline ULONG SafeArrayGetDim(SAFEARRAY* psa)
+{
+    return psa->cDims;
+}
+
+inline ULONG SafeArrayGetElemsize(SAFEARRAY* psa)
+{
+    return psa->cbElements;
+}
+
+inline HRESULT SafeArrayGetVartype(SAFEARRAY* psa, VARTYPE* pvt)
+{
+    if (!psa || !pvt)
+    {
+        return E_INVALIDARG;
+    }
+    *pvt = psa->vt;
+    return S_OK;
+}
+
+inline void VariantInit(VARIANT* pvar)
+{
+    pvar->vt     = VT_EMPTY;
+    pvar->parray = nullptr;
+}
+
+inline HRESULT VariantClear(VARIANT* pvar)
+{
+    if (pvar->vt & VT_ARRAY)
+    {
+        const auto hres = SafeArrayDestroy(pvar->parray);
+        if (FAILED(hres))
+        {
+            return hres;
+        }
+    }
+    VariantInit(pvar);
+    return S_OK;
+}
+
+#endif
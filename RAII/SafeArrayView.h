@@ -0,0 +1,194 @@
+#pragma once
+
+/**
+ * \brief Non-owning, bounds-aware view of the data of a SAFEARRAY
+ *
+ * Reading the bytes of a SAFEARRAY held by a VARIANT usually goes through
+ * CComSafeArray::Attach() (plus a ScopeGuard to Detach() it, as the VARIANT
+ * still owns the array), or through copying the data out. This class just
+ * borrows the array instead:
+ * - it checks that the array is one-dimensional and holds elements of type T
+ *   (std::runtime_error otherwise)
+ * - it locks the array for its lifetime (SafeArrayLock()/SafeArrayUnlock()),
+ *   so the data pointer stays valid
+ * - it gives direct access to the elements: begin()/end(), operator[] and a
+ *   range-checked at() (std::out_of_range), with no copy
+ *
+ * The VARIANT (or whoever owns the array) must outlive the view.
+ *
+ * On Windows this uses the real OLE Automation API. Elsewhere, a compatible
+ * declaration of SAFEARRAY, VARIANT and the SafeArray* functions used here must
+ * be included first (see SafeArrayStandIn.h).
+ *
+ * This class is Movable and NonCopyable.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <oleauto.h>
+#endif
+
+namespace WindowsUtils
+{
+
+template <typename T>
+struct VarTypeOf;
+
+template <> struct VarTypeOf<std::int8_t>   { static const VARTYPE value = VT_I1; };
+template <> struct VarTypeOf<std::uint8_t>  { static const VARTYPE value = VT_UI1; };
+template <> struct VarTypeOf<std::int16_t>  { static const VARTYPE value = VT_I2; };
+template <> struct VarTypeOf<std::uint16_t> { static const VARTYPE value = VT_UI2; };
+template <> struct VarTypeOf<std::int32_t>  { static const VARTYPE value = VT_I4; };
+template <> struct VarTypeOf<std::uint32_t> { static const VARTYPE value = VT_UI4; };
+template <> struct VarTypeOf<float>         { static const VARTYPE value = VT_R4; };
+template <> struct VarTypeOf<double>        { static const VARTYPE value = VT_R8; };
+
+template <typename T>
+class SafeArrayView
+{
+public:
+    explicit SafeArrayView(SAFEARRAY* psa);
+
+    // The array in a VARIANT of type VT_ARRAY | <type of T>
+    explicit SafeArrayView(const VARIANT& var);
+
+    SafeArrayView(const SafeArrayView&) = delete;
+    SafeArrayView& operator=(const SafeArrayView&) = delete;
+
+    SafeArrayView(SafeArrayView&& other) noexcept;
+    SafeArrayView& operator=(SafeArrayView&& other) noexcept;
+
+    ~SafeArrayView();
+
+    const T* data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    const T* begin() const { return m_data; }
+    const T* end() const { return m_data + m_size; }
+
+    // Indices are 0-based, whatever the lower bound of the array is
+    const T& operator[](std::size_t i) const { return m_data[i]; }
+    const T& at(std::size_t i) const;
+
+    long lowerBound() const { return m_lowerBound; }
+
+private:
+    static SAFEARRAY* arrayOf(const VARIANT& var);
+    void unlock();
+
+    SAFEARRAY* m_psa   = nullptr;
+    const T* m_data    = nullptr;
+    std::size_t m_size = 0;
+    long m_lowerBound  = 0;
+};
+
+template <typename T>
+SafeArrayView<T>::SafeArrayView(SAFEARRAY* psa)
+{
+    if (!psa)
+    {
+        throw std::runtime_error("SafeArrayView: null SAFEARRAY");
+    }
+    if (SafeArrayGetDim(psa) != 1)
+    {
+        throw std::runtime_error("SafeArrayView: only one-dimensional arrays are supported");
+    }
+
+    VARTYPE vt = VT_EMPTY;
+    if (FAILED(SafeArrayGetVartype(psa, &vt)) || vt != VarTypeOf<T>::value ||
+        SafeArrayGetElemsize(psa) != sizeof(T))
+    {
+        std::ostringstream oss;
+        oss << "SafeArrayView: element type mismatch (array has " << vt << ", expected "
+            << VarTypeOf<T>::value << ')';
+        throw std::runtime_error(oss.str());
+    }
+
+    const auto hres = SafeArrayLock(psa);
+    if (FAILED(hres))
+    {
+        throw std::runtime_error("SafeArrayView: failed to lock the array");
+    }
+
+    m_psa        = psa;
+    m_data       = static_cast<const T*>(psa->pvData);
+    m_size       = psa->rgsabound[0].cElements;
+    m_lowerBound = psa->rgsabound[0].lLbound;
+}
+
+template <typename T>
+SafeArrayView<T>::SafeArrayView(const VARIANT& var) : SafeArrayView(arrayOf(var))
+{
+}
+
+template <typename T>
+SafeArrayView<T>::SafeArrayView(SafeArrayView&& other) noexcept
+    : m_psa(other.m_psa), m_data(other.m_data), m_size(other.m_size), m_lowerBound(other.m_lowerBound)
+{
+    other.m_psa  = nullptr;
+    other.m_data = nullptr;
+    other.m_size = 0;
+}
+
+template <typename T>
+SafeArrayView<T>& SafeArrayView<T>::operator=(SafeArrayView&& other) noexcept
+{
+    if (this != &other)
+    {
+        unlock();
+        m_psa        = other.m_psa;
+        m_data       = other.m_data;
+        m_size       = other.m_size;
+        m_lowerBound = other.m_lowerBound;
+        other.m_psa  = nullptr;
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+    return *this;
+}
+
+template <typename T>
+SafeArrayView<T>::~SafeArrayView()
+{
+    unlock();
+}
+
+template <typename T>
+const T& SafeArrayView<T>::at(std::size_t i) const
+{
+    if (i >= m_size)
+    {
+        throw std::out_of_range("SafeArrayView: index " + std::to_string(i) + " out of range (size " +
+                                std::to_string(m_size) + ')');
+    }
+    return m_data[i];
+}
+
+template <typename T>
+SAFEARRAY* SafeArrayView<T>::arrayOf(const VARIANT& var)
+{
+    if (var.vt != (VT_ARRAY | VarTypeOf<T>::value))
+    {
+        throw std::runtime_error("SafeArrayView: VARIANT doesn't hold an array of the expected type");
+    }
+    return var.parray;
+}
+
+template <typename T>
+void SafeArrayView<T>::unlock()
+{
+    if (m_psa)
+    {
+        SafeArrayUnlock(m_psa);
+        m_psa = nullptr;
+    }
+}
+
+} // namespace WindowsUtils
@@ -0,0 +1,245 @@
+/*
+ * Parses a batch of byte-array messages held in VARIANTs, once by copying
+ * each array out (the safe way when attaching to an array we don't own) and
+ * once through SafeArrayView, which reads it in place.
+ *
+ * Builds on Windows with the real SAFEARRAY, and elsewhere with the
+ * stand-in from SafeArrayStandIn.h.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "SafeArrayStandIn.h"
+#include "SafeArrayView.h"
+
+struct ParseResult
+{
+    std::size_t records = 0;
+    std::uint32_t checksum = 0;
+};
+
+// Each message is a sequence of records: [type][length][length bytes of payload]
+template <typename Iterator>
+ParseResult parseMessage(Iterator first, Iterator last, ParseResult result)
+{
+    while (last - first >= 2)
+    {
+        const std::uint8_t type   = first[0];
+        const std::uint8_t length = first[1];
+        first += 2;
+        if (last - first < length)
+        {
+            break; // Truncated record
+        }
+        result.checksum += type;
+        for (std::uint8_t i = 0; i < length; ++i)
+        {
+            result.checksum = result.checksum * 31 + first[i];
+        }
+        first += length;
+        ++result.records;
+    }
+    return result;
+}
+
+VARIANT makeMessage(std::mt19937& gen, std::size_t size)
+{
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::uniform_int_distribution<int> length(0, 64);
+
+    VARIANT var;
+    VariantInit(&var);
+    var.vt     = VT_ARRAY | VT_UI1;
+    var.parray = SafeArrayCreateVector(VT_UI1, 0, static_cast<ULONG>(size));
+
+    auto* data = static_cast<std::uint8_t*>(var.parray->pvData);
+    for (std::size_t i = 0; i < size;)
+    {
+        data[i++] = static_cast<std::uint8_t>(byte(gen));
+        if (i < size)
+        {
+            data[i++] = static_cast<std::uint8_t>(length(gen));
+        }
+        for (int n = data[i - 1]; n > 0 && i < size; --n)
+        {
+            data[i++] = static_cast<std::uint8_t>(byte(gen));
+        }
+    }
+    return var;
+}
+
+template <typename Func>
+double measureSeconds(Func func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+template <typename Func>
+bool throws(Func func)
+{
+    try
+    {
+        func();
+    }
+    catch (std::exception&)
+    {
+        return true;
+    }
+    return false;
+}
+
+bool check(bool ok, const char* what)
+{
+    if (!ok)
+    {
+        std::cout << "Check failed: " << what << '\n';
+    }
+    return ok;
+}
+
+bool checkBehavior()
+{
+    std::mt19937 gen(4);
+    auto var   = makeMessage(gen, 16);
+    auto other = makeMessage(gen, 16);
+
+    bool ok = true;
+    {
+        WindowsUtils::SafeArrayView<std::uint8_t> view(var);
+        ok &= check(view.size() == 16 && view.data() == var.parray->pvData, "view of the VARIANT's data");
+        ok &= check(throws([&] { view.at(16); }), "at() is range-checked");
+        ok &= check(FAILED(SafeArrayDestroy(var.parray)), "the array is locked while viewed");
+    }
+    ok &= check(var.parray->cLocks == 0, "unlocked when the view is destroyed");
+
+    {
+        WindowsUtils::SafeArrayView<std::uint8_t> moved(var);
+        WindowsUtils::SafeArrayView<std::uint8_t> view(std::move(moved));
+        ok &= check(var.parray->cLocks == 1 && view.size() == 16 && moved.empty(), "move construction");
+    }
+    ok &= check(var.parray->cLocks == 0, "unlocked once after move construction");
+
+    {
+        WindowsUtils::SafeArrayView<std::uint8_t> view(var);
+        WindowsUtils::SafeArrayView<std::uint8_t> target(other);
+        target = std::move(view);
+        ok &= check(other.parray->cLocks == 0 && var.parray->cLocks == 1 && target.data() == var.parray->pvData,
+                    "move assignment releases the previous array");
+    }
+    ok &= check(var.parray->cLocks == 0, "unlocked once after move assignment");
+
+    // Indices are 0-based whatever the lower bound is
+    {
+        auto* psa  = SafeArrayCreateVector(VT_UI1, 5, 4);
+        auto* data = static_cast<std::uint8_t*>(psa->pvData);
+        data[0]    = 10;
+        data[3]    = 13;
+        {
+            WindowsUtils::SafeArrayView<std::uint8_t> view(psa);
+            ok &= check(view.lowerBound() == 5 && view.size() == 4 && view[0] == 10 && view.at(3) == 13,
+                        "non-zero lower bound");
+            ok &= check(throws([&] { view.at(4); }), "at() is range-checked with a non-zero lower bound");
+        }
+        SafeArrayDestroy(psa);
+    }
+
+    {
+        SAFEARRAYBOUND bounds[2] = {{2, 0}, {3, 0}};
+        auto* psa                = SafeArrayCreate(VT_UI1, 2, bounds);
+        ok &= check(throws([&] { WindowsUtils::SafeArrayView<std::uint8_t> view(psa); }),
+                    "multi-dimensional arrays are rejected");
+        ok &= check(psa->cLocks == 0, "a rejected array is left unlocked");
+        SafeArrayDestroy(psa);
+    }
+
+    ok &= check(throws([&] { WindowsUtils::SafeArrayView<std::uint32_t> view(var); }),
+                "VARIANT of another array type is rejected");
+    ok &= check(throws([&] { WindowsUtils::SafeArrayView<std::uint32_t> view(var.parray); }),
+                "SAFEARRAY of another element type is rejected");
+    {
+        VARIANT notArray;
+        VariantInit(&notArray);
+        notArray.vt = VT_UI1;
+        ok &= check(throws([&] { WindowsUtils::SafeArrayView<std::uint8_t> view(notArray); }),
+                    "VARIANT that isn't an array is rejected");
+    }
+    ok &= check(throws([&] { WindowsUtils::SafeArrayView<std::uint8_t> view(static_cast<SAFEARRAY*>(nullptr)); }),
+                "null SAFEARRAY is rejected");
+
+    ok &= check(SUCCEEDED(VariantClear(&var)) && SUCCEEDED(VariantClear(&other)), "arrays are unlocked at the end");
+
+    std::cout << "Behavior checks: " << (ok ? "passed" : "FAILED") << '\n';
+    return ok;
+}
+
+int main() try
+{
+    if (!checkBehavior())
+    {
+        return EXIT_FAILURE;
+    }
+
+    const std::size_t count = 20000;
+    const std::size_t size  = 4096;
+    const int passes        = 20;
+
+    std::mt19937 gen(4);
+    std::vector<VARIANT> messages;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        messages.push_back(makeMessage(gen, size));
+    }
+
+    ParseResult copied;
+    const auto copyTime = measureSeconds([&] {
+        for (int pass = 0; pass < passes; ++pass)
+        {
+            for (const auto& var : messages)
+            {
+                SafeArrayLock(var.parray);
+                const auto* data = static_cast<const std::uint8_t*>(var.parray->pvData);
+                const std::vector<std::uint8_t> bytes(data, data + var.parray->rgsabound[0].cElements);
+                SafeArrayUnlock(var.parray);
+                copied = parseMessage(bytes.begin(), bytes.end(), copied);
+            }
+        }
+    });
+
+    ParseResult viewed;
+    const auto viewTime = measureSeconds([&] {
+        for (int pass = 0; pass < passes; ++pass)
+        {
+            for (const auto& var : messages)
+            {
+                const WindowsUtils::SafeArrayView<std::uint8_t> view(var);
+                viewed = parseMessage(view.begin(), view.end(), viewed);
+            }
+        }
+    });
+
+    const double megabytes = static_cast<double>(count) * size * passes / (1024 * 1024);
+    std::cout << count << " messages of " << size << " bytes, " << passes << " passes:\n"
+              << "  copy out:      " << megabytes / copyTime << " MB/s\n"
+              << "  SafeArrayView: " << megabytes / viewTime << " MB/s\n"
+              << "  (records " << copied.records << ' ' << viewed.records << ", checksums " << copied.checksum
+              << ' ' << viewed.checksum << ")\n";
+
+    for (auto& var : messages)
+    {
+        VariantClear(&var);
+    }
+}
+catch (std::exception& e)
+{
+    std::cerr << "Exception: " << e.what() << '\n';
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace Utils
+{
+
+/**
+ * \brief RAII holder of a StateFlag, returned by StateFlag::tryEnter()/enter()
+ *
+ * Clears the flag (and wakes up whoever waits for it) when destroyed. If
+ * tryEnter() failed, the guard is empty: it converts to false and does
+ * nothing when destroyed.
+ *
+ * This class is Movable and NonCopyable.
+ */
+template <typename Flag>
+class FlagGuard
+{
+public:
+    FlagGuard() = default;
+
+    FlagGuard(const FlagGuard&) = delete;
+    FlagGuard& operator=(const FlagGuard&) = delete;
+
+    FlagGuard(FlagGuard&& other) noexcept : m_flag(other.m_flag) { other.m_flag = nullptr; }
+    FlagGuard& operator=(FlagGuard&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            m_flag       = other.m_flag;
+            other.m_flag = nullptr;
+        }
+        return *this;
+    }
+
+    ~FlagGuard() { release(); }
+
+    explicit operator bool() const { return m_flag != nullptr; }
+
+    // Clears the flag now instead of at the end of the scope
+    void release()
+    {
+        if (m_flag)
+        {
+            m_flag->leave();
+            m_flag = nullptr;
+        }
+    }
+
+private:
+    // Only the flag creates engaged guards, once it has actually been entered
+    friend Flag;
+    explicit FlagGuard(Flag* flag) : m_flag(flag) {}
+
+    Flag* m_flag = nullptr;
+};
+
+/**
+ * \brief Thread-safe "we're in the middle of X" flag
+ *
+ * A replacement for the "bool m_inX = true; + ScopeGuard that resets it"
+ * pattern when other threads check the flag too:
+ * - tryEnter() sets it only if it's clear, so it's also a reentrancy guard
+ * - enter() waits until it's clear and then sets it
+ * - waitUntilClear() blocks until whoever holds it is done
+ *
+ * Setting the flag is an acquire operation and clearing it a release one, so
+ * everything done while holding the flag is visible to the next one to get it
+ * or to whoever waited for it to clear.
+ *
+ * With CountContention = true, contentionCount() tells how many times
+ * tryEnter() failed or enter() / waitUntilClear() had to wait; otherwise the
+ * counter is never touched.
+ *
+ * Waiting uses std::atomic::wait() when available (C++20), and yields in a
+ * loop otherwise.
+ */
+template <bool CountContention = false>
+class StateFlag
+{
+public:
+    using Guard = FlagGuard<StateFlag>;
+
+    StateFlag() = default;
+    StateFlag(const StateFlag&) = delete;
+    StateFlag& operator=(const StateFlag&) = delete;
+
+    Guard tryEnter()
+    {
+        // Test before test-and-set: a failed attempt doesn't take the cache
+        // line away from the holder
+        auto expected = clear;
+        if (m_state.load(std::memory_order_relaxed) != clear ||
+            !m_state.compare_exchange_strong(expected, set, std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            countContention();
+            return Guard();
+        }
+        return Guard(this);
+    }
+
+    Guard enter()
+    {
+        for (;;)
+        {
+            auto guard = tryEnter();
+            if (guard)
+            {
+                return guard;
+            }
+            waitWhileSet();
+        }
+    }
+
+    void waitUntilClear() const
+    {
+        if (isSet())
+        {
+            countContention();
+            waitWhileSet();
+        }
+    }
+
+    bool isSet() const { return (m_state.load(std::memory_order_acquire) & set) != 0; }
+
+    std::uint64_t contentionCount() const { return m_contended.load(std::memory_order_relaxed); }
+
+private:
+    friend Guard;
+
+    // Waiters mark the state, so leaving the flag only pays for notifying
+    // them when there actually are any
+    static const std::uint32_t clear   = 0;
+    static const std::uint32_t set     = 1;
+    static const std::uint32_t waiting = 2;
+
+    void leave()
+    {
+#ifdef __cpp_lib_atomic_wait
+        if (m_state.exchange(clear, std::memory_order_release) & waiting)
+        {
+            m_state.notify_all();
+        }
+#else
+        m_state.store(clear, std::memory_order_release);
+#endif
+    }
+
+    void waitWhileSet() const
+    {
+        auto state = m_state.load(std::memory_order_acquire);
+        while (state & set)
+        {
+#ifdef __cpp_lib_atomic_wait
+            if (!(state & waiting) &&
+                !m_state.compare_exchange_weak(state, state | waiting, std::memory_order_relaxed))
+            {
+                continue;
+            }
+            m_state.wait(state | waiting, std::memory_order_acquire);
+#else
+            std::this_thread::yield();
+#endif
+            state = m_state.load(std::memory_order_acquire);
+        }
+    }
+
+    void countContention() const
+    {
+        if (CountContention)
+        {
+            m_contended.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    mutable std::atomic<std::uint32_t> m_state{clear};
+    mutable std::atomic<std::uint64_t> m_contended{0};
+};
+
+} // namespace Utils
@@ -0,0 +1,104 @@
+/*
+ * Compares the uncontended cost of entering and leaving a StateFlag with the
+ * plain "bool + ScopeGuard" version it replaces, and shows the contention
+ * counters with a few threads competing for the flag
+ */
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ScopeGuard.h"
+#include "FlagGuard.h"
+
+#ifdef _MSC_VER
+#define NOINLINE __declspec(noinline)
+#else
+#define NOINLINE __attribute__((noinline))
+#endif
+
+struct Device
+{
+    bool m_inFWUpdate = false;
+    Utils::StateFlag<> m_updating;
+    Utils::StateFlag<true> m_countedUpdating;
+    unsigned m_updates = 0;
+};
+
+NOINLINE void updateWithBool(Device& d)
+{
+    d.m_inFWUpdate        = true;
+    const auto& flagGuard = Utils::makeScopeGuard([&d] { d.m_inFWUpdate = false; });
+    ++d.m_updates;
+}
+
+NOINLINE void updateWithFlag(Device& d)
+{
+    const auto& flagGuard = d.m_updating.tryEnter();
+    if (flagGuard)
+    {
+        ++d.m_updates;
+    }
+}
+
+NOINLINE void updateWithCountedFlag(Device& d)
+{
+    const auto& flagGuard = d.m_countedUpdating.tryEnter();
+    if (flagGuard)
+    {
+        ++d.m_updates;
+    }
+}
+
+template <typename Func>
+double measureNsPerCall(Func func, Device& d, unsigned calls)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < calls; ++i)
+    {
+        func(d);
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / calls;
+}
+
+int main()
+{
+    const unsigned calls = 50000000;
+    Device d;
+
+    std::cout << "Uncontended enter/exit:\n"
+              << "  bool + ScopeGuard:     " << measureNsPerCall(updateWithBool, d, calls) << " ns\n"
+              << "  StateFlag:             " << measureNsPerCall(updateWithFlag, d, calls) << " ns\n"
+              << "  StateFlag (counting):  " << measureNsPerCall(updateWithCountedFlag, d, calls) << " ns\n";
+
+    // Four threads, each trying to do an update; the ones that don't get in
+    // wait until the running update is done
+    Utils::StateFlag<true> flag;
+    unsigned updates = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 100000; ++i)
+            {
+                if (auto guard = flag.tryEnter())
+                {
+                    ++updates;
+                    std::this_thread::yield(); // Long enough for the others to notice
+                }
+                else
+                {
+                    flag.waitUntilClear();
+                }
+            }
+        });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    std::cout << "Contended: " << updates << " updates, " << flag.contentionCount() << " contended attempts\n";
+}
@@ -25,6 +25,20 @@
     // ...
 }
 
+{
+    // ...
+    // The same, when we only need to read the bytes: WindowsUtils::SafeArrayView
+    // (RAII/SafeArrayView.h) borrows the array, checks its element type and
+    // keeps it locked, so there's nothing to detach
+    // ...
+
+    const WindowsUtils::SafeArrayView<uint8_t> bytes(vtProp);
+    for (auto b : bytes)
+    {
+        // ...
+    }
+}
+
 {
     // ...
     // Preparations to FW update
@@ -36,3 +50,21 @@
     // Continue working; status will auto reset itself
     // ...
 }
+
+{
+    // ...
+    // The same, when other threads check the flag too: a plain bool is a data
+    // race there. With m_inFWUpdate being a Utils::StateFlag<> (FlagGuard.h):
+    // ...
+
+    const auto& flagGuard = m_inFWUpdate.tryEnter();
+    if (!flagGuard)
+    {
+        // Another FW update is already running
+        return;
+    }
+
+    // Continue working; status will auto reset itself, and other threads can
+    // wait for it with m_inFWUpdate.waitUntilClear()
+    // ...
+}
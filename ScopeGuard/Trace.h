@@ -0,0 +1,217 @@
+#pragma once
+
+/**
+ * \brief Low-overhead scoped tracing, in Chrome trace format
+ *
+ * TRACE_SCOPE("name") records when the current scope was entered and left;
+ * TRACE_DUMP("trace.json") writes everything recorded so far to a file that
+ * can be loaded in chrome://tracing (or https://ui.perfetto.dev).
+ *
+ * Tracing is compiled in only if UTILS_ENABLE_TRACING is defined (before
+ * including this file, or project-wide); otherwise both macros expand to
+ * nothing, so they can stay in production code.
+ *
+ * The scope exit hook is a ScopeGuard. Timestamps come from rdtsc where
+ * available (converted to microseconds when dumping) and from
+ * std::chrono::steady_clock elsewhere. Each thread writes to its own ring
+ * buffer, so recording takes no lock and no atomic read-modify-write; when a
+ * buffer is full the oldest records are overwritten.
+ *
+ * The name has to outlive the dump; in practice, it's a string literal.
+ *
+ * TRACE_DUMP() is meant to be called when the traced threads are idle (e.g.
+ * at the end of main()); records written while dumping may come out torn.
+ * It evaluates to false if the file couldn't be written, and to true when
+ * tracing is compiled out.
+ */
+
+#ifdef UTILS_ENABLE_TRACING
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define UTILS_TRACE_HAS_RDTSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define UTILS_TRACE_HAS_RDTSC
+#endif
+
+#include "ScopeGuard.h"
+
+namespace Utils
+{
+namespace Trace
+{
+
+inline std::uint64_t steadyNanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+inline std::uint64_t now()
+{
+#ifdef UTILS_TRACE_HAS_RDTSC
+    return __rdtsc();
+#else
+    return steadyNanoseconds();
+#endif
+}
+
+struct Record
+{
+    const char* name;
+    std::uint64_t begin;
+    std::uint64_t end;
+};
+
+// Written by its thread only
+class ThreadBuffer
+{
+public:
+    static const std::size_t capacity = 1 << 16; // Power of 2
+
+    explicit ThreadBuffer(unsigned tid) : m_tid(tid) {}
+
+    void push(const Record& record)
+    {
+        const auto written = m_written.load(std::memory_order_relaxed);
+        m_records[written & (capacity - 1)] = record;
+        m_written.store(written + 1, std::memory_order_release);
+    }
+
+    template <typename Func>
+    void forEach(Func func) const
+    {
+        const auto written = m_written.load(std::memory_order_acquire);
+        const auto first   = written > capacity ? written - capacity : 0;
+        for (auto i = first; i < written; ++i)
+        {
+            func(m_records[i & (capacity - 1)]);
+        }
+    }
+
+    unsigned tid() const { return m_tid; }
+
+private:
+    const unsigned m_tid;
+    std::atomic<std::uint64_t> m_written{0};
+    std::unique_ptr<Record[]> m_records{new Record[capacity]};
+};
+
+// Buffers are kept after their thread exits, so its records are still dumped
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+    // For converting ticks to microseconds
+    const std::uint64_t originTicks = now();
+    const std::uint64_t originNs    = steadyNanoseconds();
+};
+
+inline Registry& registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+inline thread_local ThreadBuffer* threadBuffer = nullptr;
+
+inline ThreadBuffer& registerThread()
+{
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.buffers.push_back(std::make_unique<ThreadBuffer>(static_cast<unsigned>(r.buffers.size() + 1)));
+    threadBuffer = r.buffers.back().get();
+    return *threadBuffer;
+}
+
+inline void record(const char* name, std::uint64_t begin, std::uint64_t end)
+{
+    auto* buffer = threadBuffer;
+    (buffer ? *buffer : registerThread()).push({name, begin, end});
+}
+
+inline void writeJsonString(std::ostream& out, const char* s)
+{
+    out << '"';
+    for (; *s; ++s)
+    {
+        if (*s == '"' || *s == '\\')
+        {
+            out << '\\';
+        }
+        out << *s;
+    }
+    out << '"';
+}
+
+inline bool dumpChromeTrace(const std::string& path)
+{
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+#ifdef UTILS_TRACE_HAS_RDTSC
+    const auto elapsedNs  = steadyNanoseconds() - r.originNs;
+    const auto ticksPerUs = elapsedNs ? static_cast<double>(now() - r.originTicks) / elapsedNs * 1000 : 1.0;
+#else
+    const double ticksPerUs = 1000;
+#endif
+
+    // Timestamps start from the earliest record
+    auto start = now();
+    for (const auto& buffer : r.buffers)
+    {
+        buffer->forEach([&](const Record& rec) { start = rec.begin < start ? rec.begin : start; });
+    }
+
+    // Microseconds with a fixed 3 decimals: the default 6 significant digits
+    // lose precision after the first second
+    std::ofstream out(path);
+    out << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+    bool first = true;
+    for (const auto& buffer : r.buffers)
+    {
+        buffer->forEach([&](const Record& rec) {
+            out << (first ? "\n" : ",\n") << "{\"name\":";
+            writeJsonString(out, rec.name);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid() << ",\"ts\":" << (rec.begin - start) / ticksPerUs
+                << ",\"dur\":" << (rec.end - rec.begin) / ticksPerUs << '}';
+            first = false;
+        });
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+} // namespace Trace
+} // namespace Utils
+
+#define UTILS_TRACE_CONCAT_IMPL(a, b) a##b
+#define UTILS_TRACE_CONCAT(a, b) UTILS_TRACE_CONCAT_IMPL(a, b)
+
+#define TRACE_SCOPE(name)                                                                                   \
+    const auto& UTILS_TRACE_CONCAT(traceScope, __LINE__) = ::Utils::makeScopeGuard(                         \
+        [traceName = (name), traceBegin = ::Utils::Trace::now()] {                                          \
+            ::Utils::Trace::record(traceName, traceBegin, ::Utils::Trace::now());                           \
+        })
+
+#define TRACE_DUMP(path) ::Utils::Trace::dumpChromeTrace(path)
+
+#else
+
+#define TRACE_SCOPE(name) static_cast<void>(0)
+#define TRACE_DUMP(path) (static_cast<void>(0), true)
+
+#endif
@@ -0,0 +1,54 @@
+/*
+ * Measures the cost of a TRACE_SCOPE, by timing a tiny function with and
+ * without one
+ */
+
+#define UTILS_ENABLE_TRACING
+
+#include <chrono>
+#include <iostream>
+
+#include "Trace.h"
+
+#ifdef _MSC_VER
+#define NOINLINE __declspec(noinline)
+#else
+#define NOINLINE __attribute__((noinline))
+#endif
+
+NOINLINE unsigned plain(unsigned x)
+{
+    return x * 3 + 1;
+}
+
+NOINLINE unsigned traced(unsigned x)
+{
+    TRACE_SCOPE("traced");
+    return x * 3 + 1;
+}
+
+template <typename Func>
+double measureNsPerCall(Func func, unsigned calls)
+{
+    unsigned sum     = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < calls; ++i)
+    {
+        sum = func(sum);
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "(checksum " << sum << ") ";
+    return elapsed.count() / calls;
+}
+
+int main()
+{
+    const unsigned calls = 10000000;
+
+    traced(0); // Registers this thread's buffer
+
+    const auto plainNs  = measureNsPerCall(plain, calls);
+    const auto tracedNs = measureNsPerCall(traced, calls);
+    std::cout << "\nPlain call: " << plainNs << " ns, traced call: " << tracedNs
+              << " ns, overhead per scope: " << tracedNs - plainNs << " ns\n";
+}
@@ -0,0 +1,279 @@
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <cstdio>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+#include "../../RAII/MappedFile.h"
+
+class Base
+{
+public:
+    virtual ~Base() = default;
+    virtual void doSomething() = 0;
+
+    // doSomething() prints, which would make any stream of millions of
+    // selections I/O bound, so batch mode dispatches this cheap one instead
+    virtual unsigned compute(unsigned x) const = 0;
+};
+
+class Derived1 : public Base
+{
+public:
+    void doSomething() override
+    {
+        std::cout << "Derived1::doSomething()\n";
+    }
+
+    unsigned compute(unsigned x) const override { return x + 1; }
+};
+
+class Derived2 : public Base
+{
+public:
+    void doSomething() override
+    {
+        std::cout << "Derived2::doSomething()\n";
+    }
+
+    unsigned compute(unsigned x) const override { return x * 3; }
+};
+
+std::unique_ptr<Base> factory(char num)
+{
+    switch (num)
+    {
+    case '1':
+        return std::unique_ptr<Base>(new Derived1);
+    case '2':
+        return std::make_unique<Derived2>();
+    }
+    return nullptr; // or throw an exception
+}
+
+struct BatchStats
+{
+    size_t selections = 0;
+    size_t invalid    = 0;
+    unsigned checksum = 0;
+};
+
+/**
+ * Feeds selector bytes, a whole chunk at a time, to factory() and dispatches
+ * the objects; whitespace is skipped (like std::cin >> c does) and invalid
+ * choices are counted instead of stopping the run.
+ *
+ * Each object is destroyed right after it's used, rather than collected into
+ * a batch first: measured, holding a few thousand objects made it slower, as
+ * every allocation gets a different, cold block, while freeing right away
+ * keeps reusing the same one.
+ */
+class BatchDriver
+{
+public:
+    void consume(const char* data, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            const char c = data[i];
+            if (c == ' ' || c == '\n' || c == '\r' || c == '\t')
+            {
+                continue;
+            }
+
+            const auto p = factory(c);
+            if (!p)
+            {
+                ++m_stats.invalid;
+                continue;
+            }
+            m_stats.checksum = p->compute(m_stats.checksum);
+            ++m_stats.selections;
+        }
+    }
+
+    const BatchStats& stats() const { return m_stats; }
+
+private:
+    BatchStats m_stats;
+};
+
+BatchStats runBatch(const Utils::MappedFile& file)
+{
+    BatchDriver driver;
+    driver.consume(file.data(), file.size());
+    return driver.stats();
+}
+
+BatchStats runBatch(std::FILE* stream)
+{
+    std::vector<char> buffer(1 << 16);
+    BatchDriver driver;
+    for (size_t n; (n = std::fread(buffer.data(), 1, buffer.size(), stream)) > 0;)
+    {
+        driver.consume(buffer.data(), n);
+    }
+    if (std::ferror(stream))
+    {
+        throw std::runtime_error("Failed to read the selectors");
+    }
+    return driver.stats();
+}
+
+// The way main() handles a single selection, in a loop
+BatchStats runPerChar(std::istream& in)
+{
+    BatchStats stats;
+    for (char c = 0; in >> c;)
+    {
+        auto p = factory(c);
+        if (!p)
+        {
+            ++stats.invalid;
+            continue;
+        }
+        stats.checksum = p->compute(stats.checksum);
+        ++stats.selections;
+    }
+    return stats;
+}
+
+template <typename Func>
+double measureSeconds(Func func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+void report(const std::string& title, const BatchStats& stats, double seconds)
+{
+    std::cout << title << ": " << stats.selections << " selections, " << stats.invalid << " invalid, "
+              << seconds << " s, " << stats.selections / seconds << " selections/s (checksum " << stats.checksum
+              << ")\n";
+}
+
+void runBenchmarks()
+{
+    const std::string path = "selectors-benchmark.tmp";
+    const size_t count     = 50000000;
+    {
+        std::ofstream out(path, std::ios::binary);
+        std::mt19937 gen(4);
+        std::uniform_int_distribution<int> dist(0, 99);
+        std::string line;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const int r = dist(gen);
+            line += r == 0 ? 'x' : r % 2 ? '1' : '2'; // 1% invalid
+            if (line.size() == 80)
+            {
+                line += '\n';
+                out << line;
+                line.clear();
+            }
+        }
+        out << line;
+        out.close();
+        if (!out)
+        {
+            throw std::runtime_error("Failed to write " + path);
+        }
+    }
+
+    BatchStats stats;
+    double seconds = 0;
+
+    seconds = measureSeconds([&] {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+        {
+            throw std::runtime_error("Failed to open " + path);
+        }
+        stats = runPerChar(in);
+    });
+    report("Per-char operator>>", stats, seconds);
+
+    seconds = measureSeconds([&] {
+        // Closed even if runBatch() throws
+        std::unique_ptr<std::FILE, int (*)(std::FILE*)> f(std::fopen(path.c_str(), "rb"), &std::fclose);
+        if (!f)
+        {
+            throw std::runtime_error("Failed to open " + path);
+        }
+        stats = runBatch(f.get());
+    });
+    report("Batch, chunked read", stats, seconds);
+
+    seconds = measureSeconds([&] {
+        Utils::MappedFile file(path);
+        stats = runBatch(file);
+    });
+    report("Batch, mapped file ", stats, seconds);
+
+    std::remove(path.c_str());
+}
+
+int main(int argc, char* argv[]) try
+{
+    const std::string mode = argc > 1 ? argv[1] : "";
+
+    if (mode == "--benchmark")
+    {
+        runBenchmarks();
+        return 0;
+    }
+
+    // --batch [file]: process a stream of selectors, from the file or stdin
+    if (mode == "--batch")
+    {
+        BatchStats stats;
+        double seconds = 0;
+        if (argc > 2 && std::string(argv[2]) != "-")
+        {
+            seconds = measureSeconds([&] {
+                Utils::MappedFile file(argv[2]);
+                stats = runBatch(file);
+            });
+        }
+        else
+        {
+#ifdef _WIN32
+            _setmode(_fileno(stdin), _O_BINARY);
+#endif
+            seconds = measureSeconds([&] { stats = runBatch(stdin); });
+        }
+        report("Batch", stats, seconds);
+        return 0;
+    }
+
+    char c = 0;
+    std::cout << "Choose which class to instantiate (1-2): ";
+    std::cin >> c;
+
+    auto p = factory(c);
+
+    if (!p)
+    {
+        std::cout << "Invalid choice!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Now a lot of code that uses p, for example:
+    p->doSomething();
+}
+catch (std::exception& e)
+{
+    std::cerr << "Exception: " << e.what() << '\n';
+    return EXIT_FAILURE;
+}
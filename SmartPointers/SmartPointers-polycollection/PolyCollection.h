@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+namespace Utils
+{
+
+/**
+ * \brief Container of polymorphic objects, segregated by concrete type
+ *
+ * Instead of a vector of pointers to objects scattered on the heap, each
+ * concrete type gets its own contiguous segment (a std::vector<Derived>).
+ * Iterating goes segment by segment, so:
+ * - memory is accessed sequentially
+ * - the virtual call target is the same for a whole segment, so the branch
+ *   predictor always gets it right
+ * - with for_each<Derived1, Derived2, ...>() the listed types are passed to
+ *   the callback with their static type, so the calls can be devirtualized
+ *   (and inlined, if the classes are final)
+ *
+ * The price is that insertion order is not kept, only the order within each
+ * type. Derived types must be movable (the segments are plain vectors).
+ *
+ * This is a simplified take on Boost.PolyCollection's base_collection.
+ */
+template <typename Base>
+class PolyCollection
+{
+public:
+    template <typename T, typename... Args>
+    T& emplace(Args&&... args)
+    {
+        static_assert(std::is_base_of<Base, T>::value, "T must derive from Base");
+        return segment<T>().elements.emplace_back(std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    T& insert(T&& value)
+    {
+        return emplace<std::decay_t<T>>(std::forward<T>(value));
+    }
+
+    std::size_t size() const
+    {
+        std::size_t result = 0;
+        for (const auto& s : m_segments)
+        {
+            result += s->size();
+        }
+        return result;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    void clear()
+    {
+        for (auto& s : m_segments)
+        {
+            s->clear();
+        }
+    }
+
+    /**
+     * Calls func(Base&) on each element; one virtual call per segment to
+     * find it, then a tight loop over the elements
+     */
+    template <typename Func>
+    void for_each(Func func)
+    {
+        for (auto& s : m_segments)
+        {
+            forEachAsBase(*s, func);
+        }
+    }
+
+    /**
+     * Like for_each(func), but elements of the listed types are passed as
+     * Ts&, so func can be a generic lambda that gets statically dispatched
+     */
+    template <typename... Ts, typename Func, typename = std::enable_if_t<(sizeof...(Ts) > 0)>>
+    void for_each(Func func)
+    {
+        for (auto& s : m_segments)
+        {
+            if (!(forEachIfType<Ts>(*s, func) || ...))
+            {
+                forEachAsBase(*s, func);
+            }
+        }
+    }
+
+private:
+    struct SegmentBase
+    {
+        explicit SegmentBase(std::type_index t) : type(t) {}
+        virtual ~SegmentBase() = default;
+
+        virtual Base* baseData()           = 0;
+        virtual std::size_t stride() const = 0;
+        virtual std::size_t size() const   = 0;
+        virtual void clear()               = 0;
+
+        const std::type_index type;
+    };
+
+    template <typename T>
+    struct Segment : SegmentBase
+    {
+        Segment() : SegmentBase(typeid(T)) {}
+
+        // Base may not be at offset 0 of T, but its offset is the same in all
+        // the elements, so striding sizeof(T) from the first one is enough
+        Base* baseData() override { return elements.empty() ? nullptr : &elements.front(); }
+        std::size_t stride() const override { return sizeof(T); }
+        std::size_t size() const override { return elements.size(); }
+        void clear() override { elements.clear(); }
+
+        std::vector<T> elements;
+    };
+
+    // There are usually few types, so a linear search beats hashing
+    template <typename T>
+    Segment<T>& segment()
+    {
+        const std::type_index type(typeid(T));
+        for (auto& s : m_segments)
+        {
+            if (s->type == type)
+            {
+                return static_cast<Segment<T>&>(*s);
+            }
+        }
+        m_segments.push_back(std::make_unique<Segment<T>>());
+        return static_cast<Segment<T>&>(*m_segments.back());
+    }
+
+    template <typename Func>
+    static void forEachAsBase(SegmentBase& s, Func& func)
+    {
+        auto* first       = reinterpret_cast<char*>(s.baseData());
+        const auto stride = s.stride();
+        const auto count  = s.size();
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            func(*reinterpret_cast<Base*>(first + i * stride));
+        }
+    }
+
+    template <typename T, typename Func>
+    static bool forEachIfType(SegmentBase& s, Func& func)
+    {
+        if (s.type != typeid(T))
+        {
+            return false;
+        }
+        for (auto& element : static_cast<Segment<T>&>(s).elements)
+        {
+            func(element);
+        }
+        return true;
+    }
+
+    std::vector<std::unique_ptr<SegmentBase>> m_segments;
+};
+
+} // namespace Utils
@@ -0,0 +1,159 @@
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+
+#include "PolyCollection.h"
+
+class Base
+{
+public:
+    virtual ~Base() = default;
+    virtual void doSomething() = 0;
+
+    // doSomething() prints, which would hide the cost of the call itself, so
+    // the benchmark uses this cheap one instead
+    virtual unsigned compute(unsigned x) const = 0;
+};
+
+class Derived1 final : public Base
+{
+public:
+    void doSomething() override
+    {
+        std::cout << "Derived1::doSomething()\n";
+    }
+
+    unsigned compute(unsigned x) const override { return x + 1; }
+};
+
+class Derived2 final : public Base
+{
+public:
+    void doSomething() override
+    {
+        std::cout << "Derived2::doSomething()\n";
+    }
+
+    unsigned compute(unsigned x) const override { return x * 3; }
+};
+
+std::unique_ptr<Base> factory(char num)
+{
+    switch (num)
+    {
+    case '1':
+        return std::make_unique<Derived1>();
+    case '2':
+        return std::make_unique<Derived2>();
+    }
+    return nullptr; // or throw an exception
+}
+
+// Same selection as factory(), but the object is created inside the
+// collection, in the segment of its type
+bool insertFromSelector(Utils::PolyCollection<Base>& collection, char num)
+{
+    switch (num)
+    {
+    case '1':
+        collection.emplace<Derived1>();
+        return true;
+    case '2':
+        collection.emplace<Derived2>();
+        return true;
+    }
+    return false; // or throw an exception
+}
+
+template <typename Func>
+double measureSeconds(Func func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+void runBenchmarks()
+{
+    const size_t count = 1000000;
+    const int passes   = 100;
+
+    std::vector<std::unique_ptr<Base>> pointers;
+    Utils::PolyCollection<Base> collection;
+    std::mt19937 gen(4);
+    std::uniform_int_distribution<int> dist(0, 1);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const char c = static_cast<char>('1' + dist(gen));
+        pointers.push_back(factory(c));
+        insertFromSelector(collection, c);
+    }
+
+    unsigned pointersSum = 0;
+    const auto pointersTime = measureSeconds([&] {
+        for (int pass = 0; pass < passes; ++pass)
+        {
+            for (const auto& p : pointers)
+            {
+                pointersSum = p->compute(pointersSum);
+            }
+        }
+    });
+
+    unsigned virtualSum = 0;
+    const auto virtualTime = measureSeconds([&] {
+        for (int pass = 0; pass < passes; ++pass)
+        {
+            collection.for_each([&](const Base& b) { virtualSum = b.compute(virtualSum); });
+        }
+    });
+
+    unsigned staticSum = 0;
+    const auto staticTime = measureSeconds([&] {
+        for (int pass = 0; pass < passes; ++pass)
+        {
+            collection.for_each<Derived1, Derived2>([&](const auto& d) { staticSum = d.compute(staticSum); });
+        }
+    });
+
+    // The collection visits the elements in a different order, so only the
+    // two collection runs have to agree
+    const double calls = static_cast<double>(count) * passes;
+    std::cout << count << " objects, " << passes << " passes:\n"
+              << "  vector<unique_ptr<Base>>:    " << pointersTime << " s (" << pointersTime / calls * 1e9
+              << " ns/call)\n"
+              << "  PolyCollection (virtual):    " << virtualTime << " s (" << virtualTime / calls * 1e9
+              << " ns/call)\n"
+              << "  PolyCollection (restituted): " << staticTime << " s (" << staticTime / calls * 1e9
+              << " ns/call)\n"
+              << "  (checksums " << pointersSum << ' ' << virtualSum << ' ' << staticSum << ")\n";
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && std::string(argv[1]) == "--benchmark")
+    {
+        runBenchmarks();
+        return 0;
+    }
+
+    Utils::PolyCollection<Base> collection;
+    std::cout << "Choose which classes to instantiate (1-2, anything else to stop): ";
+    for (char c = 0; std::cin >> c && insertFromSelector(collection, c);)
+    {
+    }
+
+    if (collection.empty())
+    {
+        std::cout << "Invalid choice!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Grouped by type, the types in the order they were first chosen (so "2 1"
+    // prints the Derived2 objects first), each group in insertion order
+    collection.for_each<Derived1, Derived2>([](auto& d) { d.doSomething(); });
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Utils
+{
+
+/**
+ * \brief Polymorphic object held by value, with small buffer optimization
+ *
+ * What BasePointer wanted to be: it owns an object of any type derived from
+ * Base and is used through operator-> and operator*, but it is also copyable
+ * (copying the object itself, with its real type, no clone() needed) and
+ * doesn't touch the heap for objects of up to N bytes.
+ *
+ * Types that are bigger than N, over-aligned or that may throw when moved
+ * are stored on the heap instead, so moving a PolyValue never throws.
+ *
+ * Copying a PolyValue requires the stored type to be copy constructible;
+ * this is checked when the object is put into the PolyValue.
+ */
+template <typename Base, std::size_t N = 2 * sizeof(void*)>
+class PolyValue
+{
+    template <typename T>
+    static constexpr bool fitsInline = sizeof(T) <= N && alignof(T) <= alignof(std::max_align_t) &&
+                                       std::is_nothrow_move_constructible<T>::value;
+
+public:
+    PolyValue() = default;
+    PolyValue(std::nullptr_t) {}
+
+    template <typename T, typename U = std::decay_t<T>,
+              typename = std::enable_if_t<std::is_base_of<Base, U>::value>>
+    PolyValue(T&& value)
+    {
+        construct<U>(std::forward<T>(value));
+    }
+
+    template <typename T, typename... Args>
+    explicit PolyValue(std::in_place_type_t<T>, Args&&... args)
+    {
+        static_assert(std::is_base_of<Base, T>::value, "T must derive from Base");
+        construct<T>(std::forward<Args>(args)...);
+    }
+
+    PolyValue(const PolyValue& other)
+    {
+        if (other.m_ops)
+        {
+            m_ptr = other.m_ops->copy(*other.m_ptr, &m_buffer);
+            m_ops = other.m_ops;
+        }
+    }
+
+    PolyValue(PolyValue&& other) noexcept { moveFrom(other); }
+
+    PolyValue& operator=(const PolyValue& other)
+    {
+        if (this != &other)
+        {
+            PolyValue copy(other);
+            reset();
+            moveFrom(copy);
+        }
+        return *this;
+    }
+
+    PolyValue& operator=(PolyValue&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    ~PolyValue() { reset(); }
+
+    Base& operator*() const { return *m_ptr; }
+    Base* operator->() const { return m_ptr; }
+    Base* get() const { return m_ptr; }
+    explicit operator bool() const { return m_ptr != nullptr; }
+
+    // Whether the object lives in the small buffer (false when empty)
+    bool isInline() const { return m_ops && m_ops->isInline; }
+
+    void reset() noexcept
+    {
+        if (m_ops)
+        {
+            m_ops->destroy(m_ptr);
+            m_ptr = nullptr;
+            m_ops = nullptr;
+        }
+    }
+
+private:
+    // What we need to know about the stored type, one static table per type
+    struct Ops
+    {
+        Base* (*copy)(const Base& src, void* buffer);
+        Base* (*move)(Base& src, void* buffer) noexcept; // only used when isInline
+        void (*destroy)(Base* p) noexcept;
+        bool isInline;
+    };
+
+    template <typename T>
+    struct OpsFor
+    {
+        static Base* copy(const Base& src, void* buffer)
+        {
+            const auto& typed = static_cast<const T&>(src);
+            if constexpr (fitsInline<T>)
+            {
+                return new (buffer) T(typed);
+            }
+            else
+            {
+                return new T(typed);
+            }
+        }
+
+        static Base* move(Base& src, void* buffer) noexcept
+        {
+            if constexpr (fitsInline<T>)
+            {
+                return new (buffer) T(std::move(static_cast<T&>(src)));
+            }
+            else
+            {
+                return nullptr; // never called, heap objects just change owner
+            }
+        }
+
+        static void destroy(Base* p) noexcept
+        {
+            if constexpr (fitsInline<T>)
+            {
+                static_cast<T*>(p)->~T();
+            }
+            else
+            {
+                delete static_cast<T*>(p);
+            }
+        }
+
+        static constexpr Ops ops = {&copy, &move, &destroy, fitsInline<T>};
+    };
+
+    template <typename T, typename... Args>
+    void construct(Args&&... args)
+    {
+        static_assert(std::is_copy_constructible<T>::value, "PolyValue requires copyable types");
+        if constexpr (fitsInline<T>)
+        {
+            m_ptr = new (&m_buffer) T(std::forward<Args>(args)...);
+        }
+        else
+        {
+            m_ptr = new T(std::forward<Args>(args)...);
+        }
+        m_ops = &OpsFor<T>::ops;
+    }
+
+    void moveFrom(PolyValue& other) noexcept
+    {
+        if (!other.m_ops)
+        {
+            return;
+        }
+        if (other.m_ops->isInline)
+        {
+            m_ptr = other.m_ops->move(*other.m_ptr, &m_buffer);
+            m_ops = other.m_ops;
+            other.reset();
+        }
+        else
+        {
+            m_ptr       = other.m_ptr;
+            m_ops       = other.m_ops;
+            other.m_ptr = nullptr;
+            other.m_ops = nullptr;
+        }
+    }
+
+    Base* m_ptr      = nullptr; // into m_buffer or to the heap
+    const Ops* m_ops = nullptr; // nullptr when empty
+    std::aligned_storage_t<N, alignof(std::max_align_t)> m_buffer;
+};
+
+} // namespace Utils
@@ -0,0 +1,180 @@
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+
+#include "PolyValue.h"
+
+class Base
+{
+public:
+    virtual ~Base() = default;
+    virtual void doSomething() = 0;
+
+    // doSomething() prints, which would hide the cost of the call itself, so
+    // the benchmark uses this cheap one instead
+    virtual unsigned compute(unsigned x) const = 0;
+
+    // The only way to copy through unique_ptr<Base>; PolyValue doesn't need it
+    virtual std::unique_ptr<Base> clone() const = 0;
+};
+
+class Derived1 : public Base
+{
+public:
+    void doSomething() override
+    {
+        std::cout << "Derived1::doSomething()\n";
+    }
+
+    unsigned compute(unsigned x) const override { return x + 1; }
+    std::unique_ptr<Base> clone() const override { return std::make_unique<Derived1>(*this); }
+};
+
+class Derived2 : public Base
+{
+public:
+    void doSomething() override
+    {
+        std::cout << "Derived2::doSomething()\n";
+    }
+
+    unsigned compute(unsigned x) const override { return x * 3; }
+    std::unique_ptr<Base> clone() const override { return std::make_unique<Derived2>(*this); }
+};
+
+using BaseValue = Utils::PolyValue<Base>;
+
+BaseValue factory(char num)
+{
+    switch (num)
+    {
+    case '1':
+        return Derived1();
+    case '2':
+        return BaseValue(std::in_place_type<Derived2>);
+    }
+    return nullptr; // or throw an exception
+}
+
+std::unique_ptr<Base> heapFactory(char num)
+{
+    switch (num)
+    {
+    case '1':
+        return std::make_unique<Derived1>();
+    case '2':
+        return std::make_unique<Derived2>();
+    }
+    return nullptr; // or throw an exception
+}
+
+template <typename Func>
+double measureSeconds(Func func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+template <typename Container>
+unsigned callAll(const Container& objects, int passes)
+{
+    unsigned sum = 0;
+    for (int pass = 0; pass < passes; ++pass)
+    {
+        for (const auto& p : objects)
+        {
+            sum = p->compute(sum);
+        }
+    }
+    return sum;
+}
+
+void runBenchmarks()
+{
+    const size_t count = 1000000;
+    const int passes   = 20;
+
+    std::vector<char> selectors(count);
+    std::mt19937 gen(4);
+    std::uniform_int_distribution<int> dist(0, 1);
+    for (auto& c : selectors)
+    {
+        c = static_cast<char>('1' + dist(gen));
+    }
+
+    std::vector<std::unique_ptr<Base>> pointers;
+    std::vector<BaseValue> values;
+    const auto pointersConstruct = measureSeconds([&] {
+        pointers.reserve(count);
+        for (auto c : selectors)
+        {
+            pointers.push_back(heapFactory(c));
+        }
+    });
+    const auto valuesConstruct = measureSeconds([&] {
+        values.reserve(count);
+        for (auto c : selectors)
+        {
+            values.push_back(factory(c));
+        }
+    });
+
+    std::vector<std::unique_ptr<Base>> pointersCopy;
+    const auto pointersCopyTime = measureSeconds([&] {
+        pointersCopy.reserve(count);
+        for (const auto& p : pointers)
+        {
+            pointersCopy.push_back(p->clone());
+        }
+    });
+    std::vector<BaseValue> valuesCopy;
+    const auto valuesCopyTime = measureSeconds([&] { valuesCopy = values; });
+
+    unsigned pointersSum = 0;
+    unsigned valuesSum   = 0;
+    const auto pointersCall = measureSeconds([&] { pointersSum = callAll(pointers, passes); });
+    const auto valuesCall   = measureSeconds([&] { valuesSum = callAll(values, passes); });
+
+    const double calls = static_cast<double>(count) * passes;
+    std::cout << count << " objects, unique_ptr<Base> vs. PolyValue<Base>:\n"
+              << "  construction: " << pointersConstruct / count * 1e9 << " ns vs. " << valuesConstruct / count * 1e9
+              << " ns per object\n"
+              << "  copy:         " << pointersCopyTime / count * 1e9 << " ns vs. " << valuesCopyTime / count * 1e9
+              << " ns per object\n"
+              << "  call:         " << pointersCall / calls * 1e9 << " ns vs. " << valuesCall / calls * 1e9
+              << " ns per call\n"
+              << "  (checksums " << pointersSum << ' ' << valuesSum << ")\n";
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && std::string(argv[1]) == "--benchmark")
+    {
+        runBenchmarks();
+        return 0;
+    }
+
+    char c = 0;
+    std::cout << "Choose which class to instantiate (1-2): ";
+    std::cin >> c;
+
+    auto p = factory(c);
+
+    if (!p) // Unlike BasePointer, this works
+    {
+        std::cout << "Invalid choice!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Now a lot of code that uses p, for example:
+    p->doSomething();
+
+    // And, unlike BasePointer, it can be copied safely
+    auto copy = p;
+    copy->doSomething();
+}
@@ -0,0 +1,323 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Utils
+{
+
+/**
+ * \brief Occupancy of one size class, summed over all threads
+ */
+struct PoolStats
+{
+    std::size_t blockSize; // largest object that fits
+    std::size_t capacity;  // blocks carved so far
+    std::size_t inUse;     // blocks currently handed out
+};
+
+namespace detail
+{
+
+class PoolThreadCache;
+
+// Every block starts with this header; the object lives right after it
+struct alignas(std::max_align_t) PoolBlockHeader
+{
+    PoolThreadCache* owner; // nullptr if the object was too big for the pool
+    PoolBlockHeader* next;  // free list link, used only while the block is free
+};
+
+constexpr std::array<std::size_t, 5> poolSizeClasses = {16, 32, 64, 128, 256};
+constexpr std::size_t poolBlocksPerChunk = 64;
+
+constexpr std::size_t poolSizeClassOf(std::size_t size)
+{
+    std::size_t i = 0;
+    while (i < poolSizeClasses.size() && poolSizeClasses[i] < size)
+    {
+        ++i;
+    }
+    return i; // == poolSizeClasses.size() if there's no suitable class
+}
+
+/**
+ * Free list of one size class, owned by a single thread.
+ *
+ * Only the owner touches m_freeList. Other threads push the blocks they free
+ * into m_remoteFree (lock-free stack), and the owner takes the whole stack at
+ * once when its own list runs dry. Since there is a single consumer that
+ * never pops single nodes, there's no ABA problem.
+ */
+class PoolThreadCache
+{
+public:
+    explicit PoolThreadCache(std::size_t sizeClass) : m_sizeClass(sizeClass) {}
+
+    std::size_t sizeClass() const { return m_sizeClass; }
+
+    void* allocate()
+    {
+        if (!m_freeList)
+        {
+            m_freeList = m_remoteFree.exchange(nullptr, std::memory_order_acquire);
+        }
+        if (!m_freeList)
+        {
+            refill();
+        }
+
+        auto* header = m_freeList;
+        m_freeList   = header->next;
+        bumpOwnerCounter(m_allocated);
+        return header + 1;
+    }
+
+    void freeLocal(PoolBlockHeader* header)
+    {
+        header->next = m_freeList;
+        m_freeList   = header;
+        bumpOwnerCounter(m_freedLocally);
+    }
+
+    void freeRemote(PoolBlockHeader* header)
+    {
+        auto* head = m_remoteFree.load(std::memory_order_relaxed);
+        do
+        {
+            header->next = head;
+        } while (!m_remoteFree.compare_exchange_weak(head, header, std::memory_order_release,
+                                                     std::memory_order_relaxed));
+        m_freedRemotely.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    PoolStats stats() const
+    {
+        const auto freed = m_freedLocally.load(std::memory_order_relaxed) +
+                           m_freedRemotely.load(std::memory_order_relaxed);
+        return {poolSizeClasses[m_sizeClass], m_capacity.load(std::memory_order_relaxed),
+                m_allocated.load(std::memory_order_relaxed) - freed};
+    }
+
+private:
+    // Only the owner writes these, so a plain load + store is enough (no
+    // locked instruction on the hot path); the atomic is just for stats()
+    static void bumpOwnerCounter(std::atomic<std::size_t>& counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void refill()
+    {
+        const auto blockSize = sizeof(PoolBlockHeader) + poolSizeClasses[m_sizeClass];
+        m_chunks.emplace_back(new unsigned char[blockSize * poolBlocksPerChunk]);
+        auto* chunk = m_chunks.back().get();
+
+        for (std::size_t i = poolBlocksPerChunk; i-- > 0;)
+        {
+            auto* header  = reinterpret_cast<PoolBlockHeader*>(chunk + i * blockSize);
+            header->owner = this;
+            header->next  = m_freeList;
+            m_freeList    = header;
+        }
+        m_capacity.store(m_capacity.load(std::memory_order_relaxed) + poolBlocksPerChunk,
+                         std::memory_order_relaxed);
+    }
+
+    const std::size_t m_sizeClass;
+    PoolBlockHeader* m_freeList = nullptr;
+    std::atomic<PoolBlockHeader*> m_remoteFree{nullptr};
+    std::vector<std::unique_ptr<unsigned char[]>> m_chunks;
+    std::atomic<std::size_t> m_capacity{0};
+    std::atomic<std::size_t> m_allocated{0};
+    std::atomic<std::size_t> m_freedLocally{0};
+    std::atomic<std::size_t> m_freedRemotely{0};
+};
+
+// Keeps every cache ever created. Caches of threads that have exited are
+// never destroyed (other threads may still free blocks into them); they're
+// handed over to the next thread that needs one instead.
+struct PoolRegistry
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<PoolThreadCache>> caches;
+    std::array<std::vector<PoolThreadCache*>, poolSizeClasses.size()> orphans;
+};
+
+// Intentionally leaked, so pointers freed during static destruction are safe
+inline PoolRegistry& poolRegistry()
+{
+    static auto* registry = new PoolRegistry;
+    return *registry;
+}
+
+struct PoolThreadState
+{
+    std::array<PoolThreadCache*, poolSizeClasses.size()> caches{};
+
+    PoolThreadCache* get(std::size_t sizeClass)
+    {
+        auto& cache = caches[sizeClass];
+        if (!cache)
+        {
+            auto& registry = poolRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            auto& orphans = registry.orphans[sizeClass];
+            if (!orphans.empty())
+            {
+                cache = orphans.back();
+                orphans.pop_back();
+            }
+            else
+            {
+                registry.caches.push_back(std::make_unique<PoolThreadCache>(sizeClass));
+                cache = registry.caches.back().get();
+            }
+        }
+        return cache;
+    }
+
+    ~PoolThreadState()
+    {
+        auto& registry = poolRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        // Forget the caches once they're orphaned: another thread may adopt
+        // them, so a block freed later on this thread (say, by a thread_local
+        // destroyed after this one) must take the remote path
+        for (auto& cache : caches)
+        {
+            if (cache)
+            {
+                registry.orphans[cache->sizeClass()].push_back(cache);
+                cache = nullptr;
+            }
+        }
+    }
+};
+
+inline thread_local PoolThreadState poolThreadState;
+
+} // namespace detail
+
+/**
+ * \brief Per-thread, size-class object pool
+ *
+ * Each thread allocates from its own free lists, so the common path takes no
+ * lock and does no atomic read-modify-write.
+ * A block may be freed on any thread; it always goes back to the free list it
+ * came from.
+ *
+ * Objects bigger than the largest size class fall back to operator new.
+ * Over-aligned types are not supported.
+ */
+class ObjectPool
+{
+public:
+    static void* allocate(std::size_t size)
+    {
+        const auto sizeClass = detail::poolSizeClassOf(size);
+        if (sizeClass == detail::poolSizeClasses.size())
+        {
+            auto* header  = static_cast<detail::PoolBlockHeader*>(::operator new(sizeof(detail::PoolBlockHeader) + size));
+            header->owner = nullptr;
+            return header + 1;
+        }
+        return detail::poolThreadState.get(sizeClass)->allocate();
+    }
+
+    static void deallocate(void* p) noexcept
+    {
+        auto* header = static_cast<detail::PoolBlockHeader*>(p) - 1;
+        auto* owner  = header->owner;
+        if (!owner)
+        {
+            ::operator delete(header);
+        }
+        else if (owner == detail::poolThreadState.caches[owner->sizeClass()])
+        {
+            owner->freeLocal(header);
+        }
+        else
+        {
+            owner->freeRemote(header);
+        }
+    }
+
+    static std::vector<PoolStats> stats()
+    {
+        std::vector<PoolStats> result;
+        for (auto size : detail::poolSizeClasses)
+        {
+            result.push_back({size, 0, 0});
+        }
+
+        auto& registry = detail::poolRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (const auto& cache : registry.caches)
+        {
+            const auto cacheStats = cache->stats();
+            auto& total = result[cache->sizeClass()];
+            total.capacity += cacheStats.capacity;
+            total.inUse += cacheStats.inUse;
+        }
+        return result;
+    }
+};
+
+/**
+ * \brief Deleter for objects created with makePoolUnique()
+ *
+ * Stateless, so std::unique_ptr<T, PoolDeleter> is as small as a plain
+ * std::unique_ptr<T>, and converts from Derived to Base just the same.
+ */
+struct PoolDeleter
+{
+    template <typename T>
+    void operator()(T* p) const
+    {
+        // The block starts at the most derived object, not necessarily at p
+        void* block = nullptr;
+        if constexpr (std::is_polymorphic_v<T>)
+        {
+            block = dynamic_cast<void*>(p);
+        }
+        else
+        {
+            block = p;
+        }
+        p->~T();
+        ObjectPool::deallocate(block);
+    }
+};
+
+template <typename T>
+using PoolUniquePtr = std::unique_ptr<T, PoolDeleter>;
+
+/**
+ * \brief Equivalent to std::make_unique, allocating from ObjectPool
+ */
+template <typename T, typename... Args>
+PoolUniquePtr<T> makePoolUnique(Args&&... args)
+{
+    static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types are not supported");
+
+    void* block = ObjectPool::allocate(sizeof(T));
+    try
+    {
+        return PoolUniquePtr<T>(new (block) T(std::forward<Args>(args)...));
+    }
+    catch (...)
+    {
+        ObjectPool::deallocate(block);
+        throw;
+    }
+}
+
+} // namespace Utils
@@ -0,0 +1,161 @@
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+
+#include "ObjectPool.h"
+
+class Base
+{
+public:
+    virtual ~Base() = default;
+    virtual void doSomething() = 0;
+};
+
+class Derived1 : public Base
+{
+public:
+    void doSomething() override
+    {
+        std::cout << "Derived1::doSomething()\n";
+    }
+};
+
+class Derived2 : public Base
+{
+public:
+    void doSomething() override
+    {
+        std::cout << "Derived2::doSomething()\n";
+    }
+
+private:
+    int m_data[16] = {}; // Just so Derived2 lands in a different size class
+};
+
+using BasePtr = Utils::PoolUniquePtr<Base>;
+
+BasePtr factory(char num)
+{
+    switch (num)
+    {
+    case '1':
+        return Utils::makePoolUnique<Derived1>();
+    case '2':
+        return Utils::makePoolUnique<Derived2>();
+    }
+    return nullptr; // or throw an exception
+}
+
+std::unique_ptr<Base> heapFactory(char num)
+{
+    switch (num)
+    {
+    case '1':
+        return std::make_unique<Derived1>();
+    case '2':
+        return std::make_unique<Derived2>();
+    }
+    return nullptr; // or throw an exception
+}
+
+void printStats()
+{
+    for (const auto& s : Utils::ObjectPool::stats())
+    {
+        std::cout << "  size class " << s.blockSize << ": " << s.inUse << '/' << s.capacity << " in use\n";
+    }
+}
+
+template <typename Func>
+double measureSeconds(Func func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+// Keeps a window of live objects and keeps replacing the oldest one, so the
+// allocator sees interleaved creations and destructions of both types
+template <typename Factory>
+double churn(Factory factory, size_t iterations)
+{
+    const size_t window = 1024;
+    std::vector<decltype(factory('1'))> live(window);
+    return measureSeconds([&] {
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            live[i % window] = factory((i / 3) % 2 ? '1' : '2');
+        }
+    });
+}
+
+// Objects created on one thread and destroyed on another
+template <typename Factory>
+double crossThread(Factory factory, size_t count)
+{
+    std::vector<decltype(factory('1'))> objects;
+    objects.reserve(count);
+    return measureSeconds([&] {
+        for (size_t i = 0; i < count; ++i)
+        {
+            objects.push_back(factory(i % 2 ? '1' : '2'));
+        }
+        std::thread([&objects] { objects.clear(); }).join();
+        for (size_t i = 0; i < count; ++i)
+        {
+            objects.push_back(factory(i % 2 ? '1' : '2'));
+        }
+        objects.clear();
+    });
+}
+
+void runBenchmarks()
+{
+    const size_t iterations = 20000000;
+    const auto heapTime     = churn(heapFactory, iterations);
+    const auto poolTime     = churn(factory, iterations);
+    std::cout << "Create/destroy churn, " << iterations << " objects:\n"
+              << "  make_unique: " << heapTime << " s (" << heapTime / iterations * 1e9 << " ns/object)\n"
+              << "  pool:        " << poolTime << " s (" << poolTime / iterations * 1e9 << " ns/object)\n";
+
+    const size_t count   = 1000000;
+    const auto heapCross = crossThread(heapFactory, count);
+    const auto poolCross = crossThread(factory, count);
+    std::cout << "Freed on another thread, " << count << " objects x 2:\n"
+              << "  make_unique: " << heapCross << " s\n"
+              << "  pool:        " << poolCross << " s\n";
+
+    std::cout << "Pool occupancy:\n";
+    printStats();
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && std::string(argv[1]) == "--benchmark")
+    {
+        runBenchmarks();
+        return 0;
+    }
+
+    char c = 0;
+    std::cout << "Choose which class to instantiate (1-2): ";
+    std::cin >> c;
+
+    auto p = factory(c);
+
+    if (!p)
+    {
+        std::cout << "Invalid choice!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Now a lot of code that uses p, for example:
+    p->doSomething();
+
+    std::cout << "Pool occupancy:\n";
+    printStats();
+}
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace Utils
+{
+
+namespace detail
+{
+
+// FNV-1a, with the seed mixed into the offset basis and a final avalanche
+// step, as we use the low bits only
+constexpr std::uint32_t registryHash(std::string_view s, std::uint32_t seed)
+{
+    std::uint32_t h = 2166136261u ^ (seed * 0x9e3779b9u);
+    for (auto c : s)
+    {
+        h ^= static_cast<unsigned char>(c);
+        h *= 16777619u;
+    }
+    h ^= h >> 15;
+    h *= 0x2c1b3c6du;
+    h ^= h >> 12;
+    return h;
+}
+
+constexpr std::size_t nextPowerOfTwo(std::size_t n)
+{
+    std::size_t result = 1;
+    while (result < n)
+    {
+        result *= 2;
+    }
+    return result;
+}
+
+// Not std::make_unique<T>(): converting each unique_ptr<T> to unique_ptr<Base>
+// instantiates a converting constructor per type, which with hundreds of types
+// costs seconds of compilation
+template <typename Base, typename T>
+std::unique_ptr<Base> createAs()
+{
+    return std::unique_ptr<Base>(new T);
+}
+
+} // namespace detail
+
+/**
+ * \brief Factory keyed by string, built entirely at compile time
+ *
+ * Each type in Ts declares its own key:
+ *
+ *     class Derived1 : public Base
+ *     {
+ *     public:
+ *         static constexpr std::string_view key = "1";
+ *         ...
+ *     };
+ *
+ * and the registry is just a type list:
+ *
+ *     using Registry = Utils::FactoryRegistry<Base, Derived1, Derived2>;
+ *
+ * The lookup table is a perfect hash (hash and displace): keys are split into
+ * buckets by one hash, and each bucket gets a seed for a second hash that
+ * sends all its keys to free slots. Lookup is therefore two hashes and one
+ * string compare, whatever the number of types.
+ *
+ * Everything is constexpr, so there is no registration code running before
+ * main() and no static initialization order to worry about; the table ends up
+ * in the read-only data of the executable. Duplicate keys fail compilation.
+ */
+template <typename Base, typename... Ts>
+class FactoryRegistry
+{
+public:
+    using Creator = std::unique_ptr<Base> (*)();
+
+    static constexpr std::size_t size() { return sizeof...(Ts); }
+
+    // What the table takes in read-only data
+    static constexpr std::size_t tableBytes() { return sizeof(Table); }
+
+    // nullptr for unknown keys
+    static constexpr Creator find(std::string_view key)
+    {
+        const auto seed  = m_table.seeds[detail::registryHash(key, 0) % bucketCount];
+        const auto& slot = m_table.entries[detail::registryHash(key, seed) & (tableSize - 1)];
+        return slot.key == key ? slot.create : nullptr;
+    }
+
+    static std::unique_ptr<Base> create(std::string_view key)
+    {
+        const auto creator = find(key);
+        return creator ? creator() : nullptr;
+    }
+
+private:
+    static constexpr std::size_t count       = sizeof...(Ts) > 0 ? sizeof...(Ts) : 1;
+    static constexpr std::size_t tableSize   = detail::nextPowerOfTwo(2 * count);
+    static constexpr std::size_t bucketCount = (count + 3) / 4;
+
+    struct Entry
+    {
+        std::string_view key;
+        Creator create = nullptr;
+    };
+
+    struct Table
+    {
+        std::array<std::uint32_t, bucketCount> seeds{};
+        std::array<Entry, tableSize> entries{};
+    };
+
+    static constexpr Table build()
+    {
+        constexpr std::array<std::string_view, sizeof...(Ts)> keys = {Ts::key...};
+        constexpr std::array<Creator, sizeof...(Ts)> creators      = {&detail::createAs<Base, Ts>...};
+
+        // Group the keys by bucket (counting sort)
+        std::array<std::size_t, bucketCount + 1> bucketStart{};
+        std::array<std::size_t, count> bucketOf{};
+        for (std::size_t i = 0; i < keys.size(); ++i)
+        {
+            bucketOf[i] = detail::registryHash(keys[i], 0) % bucketCount;
+            ++bucketStart[bucketOf[i] + 1];
+        }
+        for (std::size_t b = 0; b < bucketCount; ++b)
+        {
+            bucketStart[b + 1] += bucketStart[b];
+        }
+        std::array<std::size_t, count> members{};
+        std::array<std::size_t, bucketCount> filled{};
+        for (std::size_t i = 0; i < keys.size(); ++i)
+        {
+            members[bucketStart[bucketOf[i]] + filled[bucketOf[i]]++] = i;
+        }
+
+        // Equal keys always share a bucket, so that's the only place to look
+        for (std::size_t b = 0; b < bucketCount; ++b)
+        {
+            for (auto m = bucketStart[b]; m < bucketStart[b + 1]; ++m)
+            {
+                for (auto other = bucketStart[b]; other < m; ++other)
+                {
+                    if (keys[members[m]] == keys[members[other]])
+                    {
+                        throw "Duplicate key in FactoryRegistry";
+                    }
+                }
+            }
+        }
+
+        // Place the biggest buckets first, while the table is still empty
+        std::array<std::size_t, bucketCount> order{};
+        for (std::size_t b = 0; b < bucketCount; ++b)
+        {
+            auto j = b;
+            for (; j > 0 && filled[order[j - 1]] < filled[b]; --j)
+            {
+                order[j] = order[j - 1];
+            }
+            order[j] = b;
+        }
+
+        Table table;
+        std::array<bool, tableSize> occupied{};
+        std::array<std::size_t, count> slots{};
+        for (auto b : order)
+        {
+            const auto first = bucketStart[b];
+            const auto last  = bucketStart[b + 1];
+            if (first == last)
+            {
+                continue;
+            }
+
+            for (std::uint32_t seed = 1;; ++seed)
+            {
+                if (seed == 1000000)
+                {
+                    throw "Could not build a perfect hash for FactoryRegistry";
+                }
+
+                bool fits = true;
+                for (auto m = first; m < last && fits; ++m)
+                {
+                    slots[m] = detail::registryHash(keys[members[m]], seed) & (tableSize - 1);
+                    fits     = !occupied[slots[m]];
+                    for (auto other = first; other < m && fits; ++other)
+                    {
+                        fits = slots[other] != slots[m];
+                    }
+                }
+                if (!fits)
+                {
+                    continue;
+                }
+
+                for (auto m = first; m < last; ++m)
+                {
+                    occupied[slots[m]]      = true;
+                    table.entries[slots[m]] = {keys[members[m]], creators[members[m]]};
+                }
+                table.seeds[b] = seed;
+                break;
+            }
+        }
+        return table;
+    }
+
+    static constexpr Table m_table = build();
+};
+
+} // namespace Utils
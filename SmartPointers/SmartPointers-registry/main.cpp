@@ -0,0 +1,185 @@
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <chrono>
+#include <random>
+#include <utility>
+
+#include "FactoryRegistry.h"
+
+class Base
+{
+public:
+    virtual ~Base() = default;
+    virtual void doSomething() = 0;
+};
+
+class Derived1 : public Base
+{
+public:
+    static constexpr std::string_view key = "1";
+
+    void doSomething() override
+    {
+        std::cout << "Derived1::doSomething()\n";
+    }
+};
+
+class Derived2 : public Base
+{
+public:
+    static constexpr std::string_view key = "2";
+
+    void doSomething() override
+    {
+        std::cout << "Derived2::doSomething()\n";
+    }
+};
+
+// Adding a type means giving it a key and listing it here; no switch to edit
+using Registry = Utils::FactoryRegistry<Base, Derived1, Derived2>;
+
+std::unique_ptr<Base> factory(std::string_view key)
+{
+    return Registry::create(key); // nullptr for unknown keys, or throw an exception
+}
+
+// For the benchmark: lots of types with keys "t0", "t1", ...
+struct GeneratedKey
+{
+    char chars[8] = {};
+    std::size_t length = 0;
+};
+
+constexpr GeneratedKey makeGeneratedKey(std::size_t i)
+{
+    GeneratedKey result;
+    char digits[8] = {};
+    std::size_t count = 0;
+    do
+    {
+        digits[count++] = static_cast<char>('0' + i % 10);
+        i /= 10;
+    } while (i > 0);
+
+    result.chars[result.length++] = 't';
+    while (count > 0)
+    {
+        result.chars[result.length++] = digits[--count];
+    }
+    return result;
+}
+
+template <std::size_t I>
+class Generated final : public Base
+{
+public:
+    static constexpr GeneratedKey keyStorage = makeGeneratedKey(I);
+    static constexpr std::string_view key{keyStorage.chars, keyStorage.length};
+
+    void doSomething() override
+    {
+        std::cout << "Generated<" << I << ">::doSomething()\n";
+    }
+};
+
+template <std::size_t... Is>
+Utils::FactoryRegistry<Base, Generated<Is>...> makeGeneratedRegistry(std::index_sequence<Is...>);
+
+template <std::size_t N>
+using GeneratedRegistry = decltype(makeGeneratedRegistry(std::make_index_sequence<N>()));
+
+// What a classic self-registering factory does: fill a map before main()
+template <std::size_t... Is>
+std::unordered_map<std::string, std::unique_ptr<Base> (*)()> makeRuntimeRegistry(std::index_sequence<Is...>)
+{
+    std::unordered_map<std::string, std::unique_ptr<Base> (*)()> result;
+    (result.emplace(std::string(Generated<Is>::key), &Utils::detail::createAs<Base, Generated<Is>>), ...);
+    return result;
+}
+
+template <typename Func>
+double measureSeconds(Func func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+template <std::size_t N>
+void benchmark()
+{
+    const size_t lookups = 10000000;
+
+    std::unordered_map<std::string, std::unique_ptr<Base> (*)()> runtimeRegistry;
+    const auto runtimeStartup = measureSeconds(
+        [&] { runtimeRegistry = makeRuntimeRegistry(std::make_index_sequence<N>()); });
+
+    // Mostly existing keys, with some misses
+    std::vector<std::string> keys;
+    std::mt19937 gen(4);
+    std::uniform_int_distribution<std::size_t> dist(0, N + N / 10);
+    for (size_t i = 0; i < 4096; ++i)
+    {
+        const auto k = makeGeneratedKey(dist(gen));
+        keys.emplace_back(k.chars, k.length);
+    }
+
+    size_t runtimeFound = 0;
+    const auto runtimeTime = measureSeconds([&] {
+        for (size_t i = 0; i < lookups; ++i)
+        {
+            runtimeFound += runtimeRegistry.count(keys[i % keys.size()]);
+        }
+    });
+
+    // Nothing has touched the constexpr table yet, so the first lookup is its
+    // whole startup cost (faulting its pages in)
+    size_t constexprFound = 0;
+    const auto constexprStartup = measureSeconds(
+        [&] { constexprFound += GeneratedRegistry<N>::find(keys[0]) != nullptr; });
+
+    const auto constexprTime = measureSeconds([&] {
+        for (size_t i = 0; i < lookups; ++i)
+        {
+            constexprFound += GeneratedRegistry<N>::find(keys[i % keys.size()]) != nullptr;
+        }
+    });
+
+    std::cout << N << " types:\n"
+              << "  startup:  unordered_map " << runtimeStartup * 1e6 << " us, constexpr (first lookup) "
+              << constexprStartup * 1e6 << " us, table " << GeneratedRegistry<N>::tableBytes() << " bytes\n"
+              << "  lookup:   unordered_map " << runtimeTime / lookups * 1e9 << " ns, constexpr "
+              << constexprTime / lookups * 1e9 << " ns\n"
+              << "  (found " << runtimeFound << ' ' << constexprFound << ")\n";
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && std::string(argv[1]) == "--benchmark")
+    {
+        benchmark<10>();
+        benchmark<100>();
+        benchmark<1000>();
+        return 0;
+    }
+
+    std::string key;
+    std::cout << "Choose which class to instantiate (1-2): ";
+    std::cin >> key;
+
+    auto p = factory(key);
+
+    if (!p)
+    {
+        std::cout << "Invalid choice!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Now a lot of code that uses p, for example:
+    p->doSomething();
+}
@@ -0,0 +1,171 @@
+#include <iostream>
+#include <memory>
+#include <variant>
+#include <optional>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+class Base
+{
+public:
+    virtual ~Base() = default;
+    virtual void doSomething() = 0;
+
+    // doSomething() prints, which would hide the cost of the call itself, so
+    // the benchmark uses this cheap one instead
+    virtual unsigned compute(unsigned x) const = 0;
+};
+
+// final lets the compiler call the functions directly whenever it knows the
+// concrete type, which is exactly what std::visit gives it
+class Derived1 final : public Base
+{
+public:
+    void doSomething() override
+    {
+        std::cout << "Derived1::doSomething()\n";
+    }
+
+    unsigned compute(unsigned x) const override { return x + 1; }
+};
+
+class Derived2 final : public Base
+{
+public:
+    void doSomething() override
+    {
+        std::cout << "Derived2::doSomething()\n";
+    }
+
+    unsigned compute(unsigned x) const override { return x * 3; }
+};
+
+std::unique_ptr<Base> factory(char num)
+{
+    switch (num)
+    {
+    case '1':
+        return std::make_unique<Derived1>();
+    case '2':
+        return std::make_unique<Derived2>();
+    }
+    return nullptr; // or throw an exception
+}
+
+// The hierarchy is closed, so we can hold the object by value: no heap
+// allocation and no indirect call. Adding a new type means adding it here.
+using BaseVariant = std::variant<Derived1, Derived2>;
+
+std::optional<BaseVariant> variantFactory(char num)
+{
+    switch (num)
+    {
+    case '1':
+        return BaseVariant(std::in_place_type<Derived1>);
+    case '2':
+        return BaseVariant(std::in_place_type<Derived2>);
+    }
+    return std::nullopt; // or throw an exception
+}
+
+// For code that only knows the Base interface
+Base& asBase(BaseVariant& v)
+{
+    return std::visit([](Base& b) -> Base& { return b; }, v);
+}
+
+template <typename Func>
+double measureSeconds(Func func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+void benchmark(const std::string& title, std::vector<char> selectors)
+{
+    const int passes = 100; // 1e6 objects * 100 passes = 1e8 calls
+
+    std::vector<std::unique_ptr<Base>> pointers;
+    std::vector<BaseVariant> variants;
+    pointers.reserve(selectors.size());
+    variants.reserve(selectors.size());
+    for (auto c : selectors)
+    {
+        pointers.push_back(factory(c));
+        variants.push_back(*variantFactory(c));
+    }
+
+    unsigned virtualSum = 0;
+    const auto virtualTime = measureSeconds([&] {
+        for (int pass = 0; pass < passes; ++pass)
+        {
+            for (const auto& p : pointers)
+            {
+                virtualSum = p->compute(virtualSum);
+            }
+        }
+    });
+
+    unsigned variantSum = 0;
+    const auto variantTime = measureSeconds([&] {
+        for (int pass = 0; pass < passes; ++pass)
+        {
+            for (const auto& v : variants)
+            {
+                variantSum = std::visit([variantSum](const auto& d) { return d.compute(variantSum); }, v);
+            }
+        }
+    });
+
+    const double calls = static_cast<double>(selectors.size()) * passes;
+    std::cout << title << ":\n"
+              << "  virtual:     " << virtualTime << " s (" << virtualTime / calls * 1e9 << " ns/call)\n"
+              << "  std::visit:  " << variantTime << " s (" << variantTime / calls * 1e9 << " ns/call)\n"
+              << "  (checksums " << virtualSum << ' ' << variantSum << ")\n";
+}
+
+void runBenchmarks()
+{
+    const size_t count = 1000000;
+    std::vector<char> selectors(count);
+    std::mt19937 gen(4);
+    std::uniform_int_distribution<int> dist(0, 1);
+    std::generate(selectors.begin(), selectors.end(), [&] { return static_cast<char>('1' + dist(gen)); });
+
+    benchmark("Mixed types", selectors);
+
+    std::sort(selectors.begin(), selectors.end());
+    benchmark("Sorted types", selectors);
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && std::string(argv[1]) == "--benchmark")
+    {
+        runBenchmarks();
+        return 0;
+    }
+
+    char c = 0;
+    std::cout << "Choose which class to instantiate (1-2): ";
+    std::cin >> c;
+
+    auto v = variantFactory(c);
+
+    if (!v)
+    {
+        std::cout << "Invalid choice!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Statically dispatched; the call can be inlined
+    std::visit([](auto& d) { d.doSomething(); }, *v);
+
+    // And still usable where a Base is expected
+    asBase(*v).doSomething();
+}